@@ -0,0 +1,59 @@
+// headers/cell.h
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "headers/tile.h"
+
+enum CellContent : uint8_t {
+    CELL_EMPTY,
+    CELL_MINE
+};
+
+// adjacentMines is filled in lazily from the chunk mine rows, see Grid::resolveAdjacentMines
+const int ADJACENT_UNRESOLVED = -1;
+
+// board storage is split into square chunks that only exist once something touches them
+const int CHUNK_SIZE = 64;
+const int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+// order of cells inside a chunk, picked when the grid is built
+// morton interleaves the x and y bits so 2d neighbourhoods (flood fill, culled drawing) share cache lines
+enum class CellLayout : uint8_t {
+    ROW_MAJOR,
+    MORTON
+};
+
+// spreads 6 bits of a local chunk coordinate onto the even bit positions
+constexpr std::array<uint16_t, CHUNK_SIZE> makeMortonSpread() {
+    std::array<uint16_t, CHUNK_SIZE> spread{};
+    for (int v = 0; v < CHUNK_SIZE; ++v)
+        for (int bit = 0; bit < 6; ++bit)
+            spread[v] |= ((v >> bit) & 1) << (bit * 2);
+    return spread;
+}
+inline constexpr std::array<uint16_t, CHUNK_SIZE> MORTON_SPREAD = makeMortonSpread();
+
+inline int chunkCellIndex(CellLayout layout, int localX, int localY) {
+    if (layout == CellLayout::MORTON)
+        return MORTON_SPREAD[localX] | (MORTON_SPREAD[localY] << 1);
+    return localY * CHUNK_SIZE + localX;
+}
+
+// byte sized fields, a chunk of cells is exactly 5 pages of 4 KiB
+struct Cell {
+    CellContent content = CELL_EMPTY;
+    TileId renderTile = TILE_BLANK;
+    bool revealed = false;
+    bool flagged = false;
+    int8_t adjacentMines = 0;
+
+    bool operator==(const Cell&) const = default;
+};
+static_assert(sizeof(Cell) == 5, "cell layout is shared with backing files");
+
+// plain data only, chunks are placement constructed straight into mapped files
+struct Chunk {
+    std::array<Cell, CHUNK_CELLS> cells;
+    std::array<uint64_t, CHUNK_SIZE> mineRows;  // bit x of row y set when (x, y) in this chunk is a mine
+};
@@ -0,0 +1,77 @@
+// headers/chunkstore.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "headers/cell.h"
+#include "headers/utils/mappedfile.h"
+
+const char BACKING_FILE_MAGIC[8] = {'D', 'S', 'W', 'P', 'G', 'R', 'I', 'D'};
+const uint32_t BACKING_FILE_VERSION = 1;
+
+// first page of a backing file
+// layout: [header page] [one state byte per chunk, page padded] [chunk slots, each a whole number of pages]
+struct BackingFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t pageSize;
+    uint64_t chunkCount;
+    uint64_t slotBytes;
+    uint64_t stateOffset;
+    uint64_t slotsOffset;
+
+    // grid state, written by Grid::persistState
+    int32_t width;
+    int32_t height;
+    int32_t numMine;
+    int32_t prngSeed;
+    int32_t safeX;
+    int32_t safeY;
+    uint8_t useSeed;
+    uint8_t firstClick;
+    uint8_t boardGenerated;
+    uint8_t gameState;
+    uint8_t cellLayout;
+    int64_t totalMines;
+    int64_t revealedSafeCells;
+    float timeElapsed;
+    int32_t numFlagged;
+    int32_t numRevealed;
+    int32_t bombsLeft;
+    char seed32[64];
+};
+
+// owns the chunk table for a grid, chunks either on the heap or in page aligned slots of a mapped file
+class ChunkStore {
+   public:
+    ChunkStore() = default;
+    ChunkStore(const ChunkStore&) = delete;
+    ChunkStore& operator=(const ChunkStore&) = delete;
+
+    void allocateHeap(size_t chunkCount);
+    void createBackingFile(const std::string& path, size_t chunkCount);
+    void openBackingFile(const std::string& path);
+    void clear();  // forget every chunk but keep the same backing
+
+    Chunk* find(size_t index) const { return table[index]; }
+    Chunk* const* tableData() const { return table.data(); }  // chunkCount entries, null until touched
+    Chunk* create(size_t index);
+    size_t chunkCount() const;
+    size_t materializedCount() const;
+
+    bool isMapped() const;
+    BackingFileHeader* header() const;
+    void flush();
+
+   private:
+    std::vector<Chunk*> table;  // null until touched
+    std::vector<std::unique_ptr<Chunk>> heapChunks;
+
+    MappedFile file;
+    uint8_t* stateBytes = nullptr;
+    uint8_t* slots = nullptr;
+    size_t slotBytes = 0;
+};
@@ -4,13 +4,10 @@
 #include <string>
 #include <vector>
 
+#include "headers/cell.h"
+#include "headers/chunkstore.h"
 #include "headers/tile.h"
-#include "raylib.h"
-
-enum CellContent {
-    CELL_EMPTY,
-    CELL_MINE
-};
+#include "headers/utils/gridutils.h"
 
 enum class GameState {
     ONGOING,
@@ -18,16 +15,6 @@ enum class GameState {
     LOST
 };
 
-struct Cell {
-    CellContent content = CELL_EMPTY;
-    TileId renderTile = TILE_BLANK;
-    bool revealed = false;
-    bool flagged = false;
-    int adjacentMines = 0;
-
-    bool operator==(const Cell&) const = default;
-};
-
 // what defines a board and its properties
 struct GridMetadata {
     int width;
@@ -48,18 +35,37 @@ struct GridEndStats {
     std::string seed32;
 };
 
+// notified when the player visible state changes, lets solvers and mirrors work incrementally
+class GridListener {
+   public:
+    virtual ~GridListener() = default;
+    virtual void onCellChanged(int x, int y) = 0;  // revealed, flagged or unflagged
+    virtual void onBoardChanged() = 0;             // regenerated or game over, rescan everything
+};
+
+// where the cells live, the default keeps row major chunks on the heap
+// backingFile maps them from a sparse file instead so boards can outgrow ram and be resumed later
+struct GridStorageOptions {
+    std::string backingFile;
+    CellLayout layout = CellLayout::ROW_MAJOR;
+};
+
 class Grid {
    public:
-    Grid(GridMetadata& metadata, const std::string& seed32, bool useSeed);
+    Grid(GridMetadata& metadata, const std::string& seed32, bool useSeed, const GridStorageOptions& storage = {});
+    explicit Grid(const std::string& backingFile);  // resume a game from its backing file
+    ~Grid();
     GameState gameState = GameState::ONGOING;
 
     void generateBoard();
     int countAdjacentMines(int x, int y);
+    int resolveAdjacentMines(int x, int y);
+    bool isMine(int x, int y) const;
     bool checkWinCondition();
-    bool validateCellInBounds(int x, int y);
+    bool validateCellInBounds(int x, int y) const;
 
     // user interactions and allowed solver interactions
-    // see solvercontroller.cpp for arbitrary "rules"
+    // see src/solver/ for the solvers built on these
     void reveal(int x, int y);
     void chord(int x, int y);
     void flag(int x, int y);
@@ -67,6 +73,22 @@ class Grid {
     int getGridWidth();
     int getGridHeight();
 
+    // chunked storage access
+    // cellAt creates the chunk on first touch, findCell and tileAt never allocate
+    Cell& cellAt(int x, int y);
+    const Cell* findCell(int x, int y) const;
+    TileId tileAt(int x, int y) const;
+    Chunk* materializeChunk(int chunkX, int chunkY);
+    const Chunk* findChunk(int chunkX, int chunkY) const;
+    size_t materializedChunks() const;
+
+    void addListener(GridListener* listener);
+    void removeListener(GridListener* listener);
+
+    // backing file, no-ops for heap storage
+    void persistState();
+    void flushBackingFile();
+
     double startTime = 0.0f;
     float timeElapsed = 0.0f;
     bool timerRunning = false;
@@ -81,7 +103,29 @@ class Grid {
     int safeY = -1;
     bool useSeed;
     std::string seed32;
-    std::vector<std::vector<Cell>> cells;
     std::string getSeed32() const;
     GridEndStats endStats;
+
+    int chunksWide = 0;
+    int chunksHigh = 0;
+    CellLayout cellLayout = CellLayout::ROW_MAJOR;
+    ChunkStore chunks;
+    gridutils::IndexPermutation minePermutation;
+    bool boardGenerated = false;
+    int64_t totalMines = 0;
+    int64_t revealedSafeCells = 0;
+
+    // zobrist hash of every stored tile, kept up to date on every tile change
+    // while the game is ongoing equal hashes mean equal boards to a solver, see solver::TranspositionCache
+    uint64_t visibleHash = 0;
+
+   private:
+    void initStorage();
+    void setTile(Cell& cell, int x, int y, TileId tile);
+    void rehashVisibleState();
+    void notifyCellChanged(int x, int y);
+    void notifyBoardChanged();
+    std::vector<GridListener*> listeners;
+    void initMinePermutation();
+    std::string backingFile;
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define INPUT_H
 
 #include "headers/grid.h"
+#include "raylib.h"
 
 struct GridCoordinates {
     int x;
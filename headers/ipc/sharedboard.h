@@ -0,0 +1,105 @@
+// headers/ipc/sharedboard.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "headers/grid.h"
+
+// the live board in a posix shared memory segment, so a bot, solver or visualizer in another process
+// reads tiles in place and queues moves without anything being serialized per move
+// the game owns the segment while a board is on screen, started with DANSWEEPER_SHM=/name (see main.cpp)
+//
+// segment layout, SharedBoardHeader at offset 0, then commandCapacity SharedCommands at commandsOffset,
+// then width * height TileId bytes at tilesOffset, index y * width + x, exactly what the game draws
+//
+// reading, a seqlock, retry while sequence is odd or changed across the read
+//   s1 = sequence (acquire), copy tiles and the fields after sequence, fence (acquire), s2 = sequence
+// writing moves, a single producer ring, the game is the only consumer
+//   h = commandHead, wait while h - commandTail == commandCapacity, fill commands[h % capacity],
+//   then commandHead = h + 1 (release), once commandTail passes h the move is applied and published
+// a new game unlinks the segment and makes a fresh one under the same name, old mappings see closed set
+namespace ipc {
+
+constexpr uint32_t SHARED_BOARD_MAGIC = 0x50575344;  // "DSWP" little endian
+constexpr uint32_t SHARED_BOARD_VERSION = 1;
+constexpr uint32_t SHARED_COMMAND_CAPACITY = 1024;
+
+enum SharedCommandKind : uint32_t {
+    SHARED_COMMAND_REVEAL = 1,
+    SHARED_COMMAND_FLAG = 2,  // toggles like a right click
+    SHARED_COMMAND_CHORD = 3,
+};
+
+struct SharedCommand {
+    uint32_t kind;  // SharedCommandKind, anything else or cells off the board are skipped
+    int32_t x;
+    int32_t y;
+    uint32_t reserved;
+};
+
+struct SharedBoardHeader {
+    // fixed for the life of the segment
+    uint32_t magic;
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    uint64_t commandsOffset;
+    uint64_t tilesOffset;
+    uint32_t commandCapacity;
+    std::atomic<uint32_t> closed;  // 1 once the game left this board, reopen by name
+
+    // written under the seqlock together with the tiles
+    alignas(64) std::atomic<uint64_t> sequence;  // odd while the game is writing
+    int32_t gameState;                           // GameState
+    int32_t numMine;
+    int64_t revealedSafeCells;
+    uint64_t visibleHash;  // Grid::visibleHash, equal hashes are equal boards
+
+    // own cache lines, one writer each
+    alignas(64) std::atomic<uint32_t> commandHead;  // written by the other process
+    alignas(64) std::atomic<uint32_t> commandTail;  // written by the game
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "shared board atomics have to work across processes");
+
+// game side of the segment, listens to the grid and publishes only the tiles that changed
+class SharedBoard : public GridListener {
+   public:
+    explicit SharedBoard(const std::string& name);  // throws std::runtime_error where there is no posix shm
+    ~SharedBoard() override;
+    SharedBoard(const SharedBoard&) = delete;
+    SharedBoard& operator=(const SharedBoard&) = delete;
+
+    // makes the segment for this grid, nullptr closes it, throws std::runtime_error if it can't be made
+    void attach(Grid* grid);
+
+    // once a frame, applies queued moves then publishes everything changed since the last call
+    void update();
+
+    void onCellChanged(int x, int y) override;
+    void onBoardChanged() override;
+
+   private:
+    void openSegment();
+    void closeSegment();
+    void applyCommands();
+    void publish();
+    void copyAllTiles();
+
+    std::string name;
+    Grid* grid = nullptr;
+
+    uint8_t* base = nullptr;
+    size_t length = 0;
+    SharedBoardHeader* header = nullptr;
+    SharedCommand* commands = nullptr;
+    uint8_t* tiles = nullptr;
+
+    std::vector<int64_t> dirty;  // cells changed since the last publish
+    bool allDirty = false;
+};
+
+}  // namespace ipc
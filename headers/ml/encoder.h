@@ -0,0 +1,44 @@
+// headers/ml/encoder.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "headers/grid.h"
+
+// what a player sees as one hot planes, written straight into a caller's tensor
+// tiles are read from the chunk storage a row at a time, untouched chunks are known to be all unknown without reading
+// until a loss, when their mines are shown like the game draws them
+// make encoder builds this with the board engine as a library, so a pipeline outside the repo can link it
+namespace ml {
+
+enum class TensorLayout : uint8_t {
+    NCHW,  // board, channel, row, column
+    NHWC,  // board, row, column, channel
+};
+
+// channel order, numbers 0..8 follow the flag channel
+enum ObservationChannel : uint8_t {
+    CHANNEL_UNKNOWN = 0,  // unopened, question marks included
+    CHANNEL_FLAG = 1,     // flagged, or a mine shown after a loss
+    CHANNEL_NUMBER_0 = 2,
+};
+constexpr int OBSERVATION_CHANNELS = CHANNEL_NUMBER_0 + 9;
+
+// values per board, output holds count times this many, board i starts at i * observationSize
+size_t observationSize(const Grid& grid);
+
+// every grid has to be the same size, throws std::runtime_error otherwise
+// 1.0f or 1 for the channel a cell shows, 0 everywhere else
+void encodeBoards(const Grid* const* grids, size_t count, TensorLayout layout, float* output);
+void encodeBoards(const Grid* const* grids, size_t count, TensorLayout layout, uint8_t* output);
+
+inline void encodeBoard(const Grid& grid, TensorLayout layout, float* output) {
+    const Grid* grids[] = {&grid};
+    encodeBoards(grids, 1, layout, output);
+}
+inline void encodeBoard(const Grid& grid, TensorLayout layout, uint8_t* output) {
+    const Grid* grids[] = {&grid};
+    encodeBoards(grids, 1, layout, output);
+}
+
+}  // namespace ml
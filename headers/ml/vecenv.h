@@ -0,0 +1,71 @@
+// headers/ml/vecenv.h
+#pragma once
+#include <stdint.h>
+
+// c abi for stepping many boards in lockstep, for reinforcement learning (see dansweeper-ml)
+// every board has the same size, cell state of all boards lives in shared arrays, board b's cells start at b * cells,
+// so a step is a pass over the actions and the observations are one copy out of those arrays
+// nothing is allocated after create, callers own every buffer passed in
+//
+// an action reveals one cell, index y * width + x, the first reveal of an episode is always safe
+// mines are placed exactly like a seeded Grid, the board an episode played is the game's board for
+// createSeedFromManualInput(width, height, mines, first x, first y, episode seed) on boards the game can show
+// boards that finish are reset on the spot, the observation returned with done set is already the next episode's
+//
+// not thread safe, one env per thread for more cores
+
+#if defined(_WIN32)
+#define DANSWEEPER_API __declspec(dllexport)
+#else
+#define DANSWEEPER_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// observation value of a cell not revealed yet, revealed cells show their number 0..8
+#define DANSWEEPER_HIDDEN 9
+
+enum {
+    DANSWEEPER_OK = 0,
+    DANSWEEPER_INVALID_ARGUMENT = -1,  // null buffer or an action outside the board, nothing was stepped
+};
+
+typedef struct dansweeper_vecenv dansweeper_vecenv;
+
+typedef struct dansweeper_vecenv_config {
+    int32_t width;
+    int32_t height;
+    int32_t mines;
+    int32_t max_steps;    // episode ends after this many steps, 0 for no limit
+    float reward_win;     // on the step revealing the last safe cell
+    float reward_loss;    // on revealing a mine
+    float reward_reveal;  // any other step that revealed something
+    float reward_repeat;  // revealing a cell that is already revealed
+} dansweeper_vecenv_config;
+
+// 1 for a win, -1 for a loss, 0.1 for progress, -0.1 for wasted steps, no step limit
+DANSWEEPER_API dansweeper_vecenv_config dansweeper_vecenv_default_config(int32_t width, int32_t height, int32_t mines);
+
+// null when the config is invalid, mines has to leave at least one safe cell
+DANSWEEPER_API dansweeper_vecenv* dansweeper_vecenv_create(int32_t boards, const dansweeper_vecenv_config* config,
+                                                           uint64_t seed);
+DANSWEEPER_API void dansweeper_vecenv_destroy(dansweeper_vecenv* env);
+
+DANSWEEPER_API int32_t dansweeper_vecenv_boards(const dansweeper_vecenv* env);
+DANSWEEPER_API int32_t dansweeper_vecenv_cells(const dansweeper_vecenv* env);  // observation bytes per board
+
+// starts a new episode on every board, observations holds boards * cells bytes
+DANSWEEPER_API int32_t dansweeper_vecenv_reset_batch(dansweeper_vecenv* env, uint8_t* observations);
+
+// one action per board, observations boards * cells bytes, rewards and dones one per board
+DANSWEEPER_API int32_t dansweeper_vecenv_step_batch(dansweeper_vecenv* env, const int32_t* actions, uint8_t* observations,
+                                                    float* rewards, uint8_t* dones);
+
+// seed of the episode a board is playing, with the first action it replays in the game
+DANSWEEPER_API uint32_t dansweeper_vecenv_episode_seed(const dansweeper_vecenv* env, int32_t board);
+
+#ifdef __cplusplus
+}
+#endif
@@ -18,9 +18,17 @@ void CenterCameraOnMap(const Grid* grid);
 int GetMapPixelWidth();
 int GetMapPixelHeight();
 
-void QueueHighlight(int x, int y);
+// lock free, callable from any thread, false when the queue is full and the tile was dropped
+// queued tiles are drawn once by the next frame
+bool QueueHighlight(int x, int y);
 void highlightTile();
 
+// mine probability overlay, one grayscale texel per cell shaded in a single quad by a fragment shader
+// heat is width * height bytes, 0 draws nothing and 1..255 runs from safe to mine, see solver::Hint::heat
+// false for boards past the texture size limit, nothing is shown for those
+bool ShowHeatmap(int width, int height, const unsigned char* heat);
+void HideHeatmap();
+
 void DrawScreenBorderFromTileset(Texture2D borderTexture, int sliceSize);
 }  // namespace render
 
@@ -0,0 +1,38 @@
+// headers/solver/anytime.h
+#pragma once
+#include <chrono>
+
+#include "headers/grid.h"
+#include "headers/solver/endgame.h"
+#include "headers/solver/probability.h"
+#include "headers/solver/singlepoint.h"
+
+namespace solver {
+
+enum class AnytimeStage {
+    RULES,    // single point rules found something or ran out of budget, only certain is filled
+    ENDGAME,  // few enough cells left to enumerate them all
+    EXACT,    // every component enumerated
+    SAMPLED,  // some components were estimated to stay within the budget
+};
+
+// best answer found within a time budget, for hints and real time bots
+// single point rules go first since they are incremental and usually enough on their own,
+// then the endgame solver once few cells are left,
+// then exact enumeration smallest component first, then sampling for whatever is left
+class AnytimeSolver {
+   public:
+    // sampler is optional, see ProbabilitySolver::sampler
+    explicit AnytimeSolver(Grid* grid, MonteCarloEstimator* sampler = nullptr);
+
+    // the rules share the budget too, an answer with nothing in it while pending() only means call again
+    ProbabilityMap solve(std::chrono::microseconds budget);
+    bool pending() const { return rules.pending(); }
+
+    AnytimeStage lastStage = AnytimeStage::RULES;
+    SinglePointSolver rules;
+    EndgameSolver endgame;
+    ProbabilitySolver probabilities;
+};
+
+}  // namespace solver
@@ -0,0 +1,71 @@
+// headers/solver/autoplay.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "headers/grid.h"
+#include "headers/solver/anytime.h"
+#include "headers/solver/montecarlo.h"
+#include "headers/solver/plugin.h"
+
+namespace solver {
+
+// plays a grid on its own thread as fast as its solver answers, the game only draws whatever it has reached
+// the worker holds the grid's lock for a batch, a solve or the certain moves left over from one, and a batch ends
+// as soon as a frame is waiting, so the solver budget bounds how long a frame can wait and moves are never tied
+// to the display rate
+// every other read or change of the grid, drawing included, has to happen under lock() while a player exists
+class AutoPlayer {
+   public:
+    // a plugin solver when plugin is given, the anytime solver otherwise
+    // samplerThreads above 0 gives the anytime solver a pool of that many threads for components it has to sample
+    AutoPlayer(Grid* grid, const SolverPlugin* plugin = nullptr,
+               std::chrono::microseconds budget = std::chrono::milliseconds(5), unsigned samplerThreads = 0);
+    ~AutoPlayer();  // never while holding lock(), the worker is joined
+    AutoPlayer(const AutoPlayer&) = delete;
+    AutoPlayer& operator=(const AutoPlayer&) = delete;
+
+    std::unique_lock<std::mutex> lock();
+
+    // a paused player keeps its solver but makes no moves
+    void setPaused(bool paused) { this->paused.store(paused, std::memory_order_relaxed); }
+
+    bool finished() const { return done.load(std::memory_order_acquire); }  // game over or nothing left to try
+    uint64_t movesPlayed() const { return moves.load(std::memory_order_relaxed); }
+    uint64_t guessesPlayed() const { return guesses.load(std::memory_order_relaxed); }
+
+   private:
+    struct QueuedMove {
+        CellPos cell;
+        bool mine;
+    };
+
+    bool step();
+    void run();
+
+    Grid* grid;
+    std::chrono::microseconds budget;
+    std::unique_ptr<MonteCarloEstimator> sampler;  // before the solver that points at it
+    std::unique_ptr<AnytimeSolver> anytime;
+    std::unique_ptr<PluginSolver> pluginSolver;
+    std::deque<QueuedMove> queued;  // certain moves of the last solve not played yet, they stay certain
+    bool solvedOnce = false;
+    uint64_t solvedHash = 0;  // board the last solve answered, still the same once its moves are played means stuck
+
+    std::mutex mutex;
+    std::atomic<int> waiting{0};  // game threads blocked in lock(), the worker yields to them between batches
+    std::atomic<bool> paused{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> moves{0};
+    std::atomic<uint64_t> guesses{0};
+
+    std::thread thread;  // last, so everything above exists before it starts
+};
+
+}  // namespace solver
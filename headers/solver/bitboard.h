@@ -0,0 +1,55 @@
+// headers/solver/bitboard.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/solver/solver.h"
+
+namespace solver {
+
+// the two trivial rules over the whole board at once, no cell is looked at on its own
+// the visible board becomes bit planes with 64 cells per word, neighbour counts are added bit sliced,
+// both rules are compared word wide and what they force is spread back onto the neighbours with shifts
+// passes repeat over numbers next to the last changes until nothing changes, a 10k x 10k board takes about half a
+// second on one core and reading the cells is half of that
+// only reads what a player sees, flags are trusted as mines, like the other solvers
+class BitboardSolver {
+   public:
+    explicit BitboardSolver(Grid* grid);
+
+    // reads the grid into planes and runs both rules to a fixpoint, returns every cell they decide
+    // nothing is kept between calls, for a few cells at a time SinglePointSolver is the cheaper one
+    Deductions solve();
+
+    int iterations = 0;        // passes the last solve took
+    uint64_t rowsCounted = 0;  // rows whose numbers were checked over all passes, a full sweep is the board height
+
+   private:
+    void load();
+    bool countRow(int y, bool everything);
+    bool applyRow(int y);
+    void nearRows(const std::vector<int>& from, std::vector<int>& to);
+    uint64_t* row(std::vector<uint64_t>& plane, int y) { return plane.data() + static_cast<size_t>(y + 1) * stride + 1; }
+
+    Grid* grid;
+    int width = 0;
+    int height = 0;
+    int words = 0;   // words that hold cells per row, rounded up to whole simd lanes
+    int stride = 0;  // words plus a zero word each side, rows above and below the board are zero too
+
+    // one bit per cell, padding stays zero so shifts never need an edge case
+    std::vector<uint64_t> revealed;
+    std::vector<uint64_t> open;     // neither revealed, flagged nor decided
+    std::vector<uint64_t> mines;    // flagged or decided mines
+    std::vector<uint64_t> number[4];  // revealed numbers, bit sliced, plane p holds bit p
+    std::vector<uint64_t> clearing;   // numbers with all their mines found, set for one pass
+    std::vector<uint64_t> filling;    // numbers with as many open cells as mines missing, set for one pass
+    std::vector<uint64_t> safe;       // decided safe
+    std::vector<uint64_t> decided;    // decided mines, without the flags
+    std::vector<uint64_t> changes;    // decided by the last pass
+    std::vector<uint32_t> stamps;     // per row, the last nearRows call that listed it
+    uint32_t stamp = 0;
+};
+
+}  // namespace solver
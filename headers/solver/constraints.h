@@ -0,0 +1,102 @@
+// headers/solver/constraints.h
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace solver {
+
+// one independent piece of the frontier, open cells linked by shared numbers
+struct Component {
+    struct Rule {
+        std::vector<int> vars;  // indexes into cells
+        int mines;
+    };
+
+    std::vector<int64_t> cells;  // sorted cell keys
+    std::vector<Rule> rules;
+};
+
+// every way a component can be filled, bucketed by how many mines it uses
+struct ComponentSolution {
+    std::vector<double> ways;        // ways[m], consistent fillings with m mines
+    std::vector<double> cellWays;    // cellWays[(m - minMines) * cells + i], of those how many put a mine on cells[i]
+    std::vector<uint8_t> clearSeen;  // same layout, some filling with m mines leaves cells[i] clear
+    int minMines = 0;                // cellWays only holds rows minMines..maxMines
+    int maxMines = -1;
+    bool exact = true;     // false for sampled estimates, ways and cellWays are then only proportional
+    uint64_t samples = 0;  // fillings drawn when sampled, dead ends included
+};
+
+using Deadline = std::chrono::steady_clock::time_point;
+
+// raw totals of a run of descents, kept per group so threads sampling one component have little to merge
+struct SampleTally {
+    std::vector<double> ways;                      // ways[m]
+    std::vector<std::vector<double>> groupWays;    // groupWays[m][group], mines the group held, weighted
+    std::vector<std::vector<uint8_t>> groupClear;  // same layout, some filling with m mines left a cell of the group clear
+    uint64_t samples = 0;
+    uint64_t leaves = 0;
+};
+
+// enumerates a component over groups of cells instead of single cells
+// each cell gets a bitmask of the rules it is in, cells with equal masks are interchangeable,
+// so a group of k cells is assigned a mine count j once and weighted by C(k, j)
+class ConstraintEngine {
+   public:
+    explicit ConstraintEngine(const Component& component);
+
+    // every filling, exact unless the node budget or deadline runs out first
+    ComponentSolution enumerate(uint64_t nodeBudget, Deadline deadline = Deadline::max());
+    // random descents weighted by how many fillings each step skipped (knuth's estimator),
+    // unbiased for ways and cellWays up to a common scale
+    // a count is only drawn if every open neighbouring group can still fit, which keeps long chains from dead ending
+    ComponentSolution sample(std::mt19937_64& gen, uint64_t maxSamples, Deadline deadline = Deadline::max());
+    // the same descents added to a tally, for samplers that run one engine per thread and merge
+    // weights are scaled by 2^exponent so every engine agrees on the scale and huge components stay finite
+    void sampleInto(SampleTally& tally, std::mt19937_64& gen, uint64_t descents, int exponent = 0);
+    // a sampled solution from a tally, merged or not
+    ComponentSolution finishTally(SampleTally& tally);
+    size_t groupCount() const { return groupSize.size(); }
+    int groupCells(size_t group) const { return groupSize[group]; }
+    int cellCount() const { return count; }
+    uint64_t nodesVisited() const { return nodes; }
+
+   private:
+    void search(size_t depth, int mines, double weight);
+    bool descend(std::mt19937_64& gen);
+    bool viable(int group, int take);
+    void record(int mines, double weight);
+    void begin(ComponentSolution& result);
+    void resetBranch();
+    void finish(ComponentSolution& result);
+
+    int count;
+    std::vector<int> groupOf;  // per cell
+    std::vector<int> groupSize;
+    std::vector<std::vector<int>> groupRules;
+    std::vector<std::vector<int>> ruleGroups;
+    std::vector<int> order;  // groups in the order they get assigned
+
+    std::vector<int> needed;    // per rule
+    std::vector<int> placed;    // mines in assigned groups
+    std::vector<int> capacity;  // cells in unassigned groups
+    std::vector<int> ruleSize;
+    std::vector<int> chosen;    // mines per group on the current branch
+    std::vector<uint8_t> assigned;
+    // per mine count and group, a row is only allocated once a leaf uses that many mines, most never do
+    std::vector<std::vector<double>> groupWays;
+    std::vector<std::vector<uint8_t>> groupClear;  // some leaf left a cell of the group clear
+    ComponentSolution* solution = nullptr;
+    double weightScale = 1.0;  // starting weight of a descent
+    Deadline deadline;
+    uint64_t nodeBudget = 0;
+    uint64_t nodes = 0;
+    bool aborted = false;
+};
+
+ComponentSolution enumerateComponent(const Component& component, uint64_t nodeBudget);
+
+}  // namespace solver
@@ -0,0 +1,65 @@
+// headers/solver/endgame.h
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/solver/probability.h"
+#include "headers/solver/solver.h"
+
+namespace solver {
+
+// exact answers once only a few cells are left, every placement of the remaining mines is enumerated
+// each unknown cell is one bit of a word, so a placement is a mask and a number is checked with one popcount
+// cells no number touches are not enumerated, they are counted with a binomial at every frontier placement
+// flags are trusted as mines, like the other solvers
+class EndgameSolver {
+   public:
+    explicit EndgameSolver(Grid* grid);
+
+    // false, leaving result alone, when more than maxUnknowns cells are left or the board contradicts itself
+    // otherwise fills result like ProbabilitySolver::solve, the best guess is the safest cell and among equally
+    // safe ones the one whose number tells the most
+    bool solve(ProbabilityMap& result);
+
+    static constexpr int MAX_UNKNOWNS = 64;  // one bit per cell in a 64 bit word
+    int maxUnknowns = 40;                    // well under 10 ms, near 64 some boards take twice that
+    uint64_t nodeBudget = 20'000'000;  // search nodes before giving up
+    size_t maxStored = 1 << 14;        // placements kept for the information tie break, past this ties stay unbroken
+
+    uint64_t placements = 0;       // frontier placements found by the last solve
+    uint64_t nodes = 0;            // search nodes of the last solve
+    double bestGuessEntropy = 0.0;  // bits the number under the last best guess gives on average
+
+   private:
+    // bit planes of a per cell counter, plane p holds bit p of every cell's count
+    static constexpr int PLANES = 48;
+    using Counter = std::array<uint64_t, PLANES>;
+
+    struct Rule {
+        uint64_t mask;
+        int mines;
+    };
+
+    bool collect();
+    void search(int depth, uint64_t mines, int placed);
+    double entropyOf(int cell, const std::vector<double>& completions);
+
+    Grid* grid;
+    std::vector<CellPos> cells;  // bit i is cells[i], frontier cells first in search order
+    int frontierCount = 0;
+    int interiorCount = 0;
+    int minesLeft = 0;
+    std::vector<Rule> rules;
+    std::vector<std::vector<int>> cellRules;  // rules touching each frontier cell
+    std::vector<uint64_t> neighborMask;       // per cell, frontier neighbours as bits
+    std::vector<int> interiorNeighbors;       // per cell, neighbours that are interior cells
+
+    std::vector<uint64_t> found;  // placements per frontier mine count
+    std::vector<Counter> counts;  // per frontier mine count, how often each cell held a mine
+    std::vector<uint64_t> stored;
+    bool overflow = false;
+};
+
+}  // namespace solver
@@ -0,0 +1,96 @@
+// headers/solver/hints.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/solver/montecarlo.h"
+#include "headers/solver/solver.h"
+#include "headers/solver/transposition.h"
+
+namespace solver {
+
+// cells worth pointing at on one board, tagged with the board they were worked out for
+struct Hint {
+    uint64_t visibleHash = 0;
+    std::vector<CellPos> safe;  // certain
+    CellPos guess = {-1, -1};   // least likely mine, only when nothing is certain
+    double guessProbability = 1.0;
+
+    // width * height row major while the worker's heatmap is on, empty otherwise
+    // 0 for revealed and flagged cells, 1..255 for mine probability 0..1 of every open one
+    std::vector<uint8_t> heat;
+};
+
+// works hints out on its own thread so the game loop never waits on a solver
+// when the board changes the game thread copies the visible tiles of touched chunks, the worker rebuilds a private
+// grid from that copy and solves it, so the live grid is only ever read by its own thread
+// a hint is handed back only while its hash is still the board's, one for an older board is dropped
+class HintWorker {
+   public:
+    // samplerThreads above 0 samples components too big to enumerate on a pool of that many threads, see
+    // MonteCarloEstimator, 0 samples them on the worker thread
+    explicit HintWorker(std::chrono::microseconds budget = std::chrono::milliseconds(50), unsigned samplerThreads = 0);
+    ~HintWorker();
+    HintWorker(const HintWorker&) = delete;
+    HintWorker& operator=(const HintWorker&) = delete;
+
+    // once a frame from the thread that plays grid, null until a hint for the board as it is now is ready
+    // the pointer stays valid until the next call
+    const Hint* poll(const Grid& grid);
+
+    // heat needs every probability, so hints come from a full probability solve rather than the rules first
+    // turning it on solves the current board again, game thread only like poll
+    void setHeatmap(bool enabled);
+    bool heatmapEnabled() const { return heatmap.load(std::memory_order_relaxed); }
+
+    // boards with more touched chunks than this get no hints, copying them would cost the game thread a frame
+    static constexpr size_t MAX_SNAPSHOT_CHUNKS = 256;
+
+   private:
+    // what a player sees of the board, renderTile of every cell of every touched chunk in chunk order
+    struct Snapshot {
+        int width;
+        int height;
+        int numMine;
+        CellLayout layout;
+        int64_t totalMines;
+        int64_t revealedSafeCells;
+        uint64_t visibleHash;
+        std::vector<size_t> chunkIndices;
+        std::vector<TileId> tiles;  // CHUNK_CELLS per chunk
+    };
+
+    static std::unique_ptr<Snapshot> takeSnapshot(const Grid& grid);
+    Hint solve(const Snapshot& snapshot);
+    void run();
+
+    std::chrono::microseconds budget;
+    std::atomic<bool> heatmap{false};
+    TranspositionCache transpositions;  // components carry over from one hint to the next
+    std::unique_ptr<MonteCarloEstimator> sampler;  // worker thread only, null without sampler threads
+
+    // guarded by mutex, held for a pointer move or a swap and never while copying or solving
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::unique_ptr<Snapshot> pending;  // newest board not picked up yet, a newer one replaces it unsolved
+    Hint ready;
+    bool stopping = false;
+    std::atomic<bool> published{false};  // ready holds a hint poll hasn't taken, checked without the lock
+
+    // game thread only
+    bool submitted = false;
+    uint64_t submittedHash = 0;
+    bool hasCurrent = false;
+    Hint current;
+
+    std::thread thread;  // last, so everything above exists before it starts
+};
+
+}  // namespace solver
@@ -0,0 +1,90 @@
+// headers/solver/montecarlo.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "headers/solver/constraints.h"
+
+namespace solver {
+
+// how far the last estimate got, callers trade accuracy for latency through maxSamples, the deadline and targetError
+struct SampleStats {
+    uint64_t samples = 0;        // descents over all threads, dead ends included
+    uint64_t leaves = 0;         // descents that reached a consistent filling
+    uint64_t batches = 0;        // merges into the shared totals
+    double standardError = 0.0;  // worst over cells, from the spread between batches, ignores the global mine count
+    bool converged = false;      // stopped because standardError fell under the target
+};
+
+// knuth descents on a pool of threads, each with its own engine and random stream
+// threads sample a batch locally and add it into the shared totals with atomics, nothing on the hot path locks
+// results are not reproducible across runs with more than one thread, batches merge in whatever order they finish
+class MonteCarloEstimator {
+   public:
+    explicit MonteCarloEstimator(unsigned threads = 0, uint64_t seed = 0x5eed);  // 0 is one thread per core
+    ~MonteCarloEstimator();
+    MonteCarloEstimator(const MonteCarloEstimator&) = delete;
+    MonteCarloEstimator& operator=(const MonteCarloEstimator&) = delete;
+
+    // stops at maxSamples, at the deadline or once the worst standard error is under targetError, whichever comes first
+    // like ConstraintEngine::sample it keeps going past the deadline until one descent got through, up to a limit
+    ComponentSolution estimate(const Component& component, uint64_t maxSamples, Deadline deadline = Deadline::max(),
+                               double targetError = 0.0);
+    unsigned threadCount() const { return static_cast<unsigned>(workers.size()); }
+
+    SampleStats stats;
+    uint64_t batchSize = 64;  // descents between clock reads, batches merge once they hit enough of them per mine count
+
+   private:
+    void work(unsigned index);
+    void merge(SampleTally& tally, std::vector<double>& batchGroups);
+    bool shouldStop();
+    double standardError() const;
+
+    std::vector<std::thread> workers;
+    std::vector<std::mt19937_64> streams;  // one per thread, seeded apart
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    uint64_t generation = 0;
+    unsigned running = 0;
+    bool quitting = false;
+
+    // the current job, written under the mutex before a generation starts and only read while it runs
+    const Component* component = nullptr;
+    int exponent = 0;
+    uint64_t maxSamples = 0;
+    Deadline deadline;
+    double targetError = 0.0;
+    size_t groups = 0;
+    std::vector<int> groupCells;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> converged{false};
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> leaves{0};
+    std::atomic<uint64_t> batches{0};
+    // per mine count, allocated by whichever thread first merges a filling with that many mines
+    struct SharedRow {
+        explicit SharedRow(size_t groups) : groupWays(groups), groupClear(groups) {}
+        std::vector<std::atomic<double>> groupWays;
+        std::vector<std::atomic<uint8_t>> groupClear;
+    };
+    SharedRow* rowFor(size_t mines);
+
+    std::vector<std::atomic<double>> ways;
+    std::vector<std::atomic<SharedRow*>> rows;
+    // batch moments for the standard error, C is a batch's weighted mines in a group and W its total weight
+    std::vector<std::atomic<double>> sumC;
+    std::vector<std::atomic<double>> sumCC;
+    std::vector<std::atomic<double>> sumCW;
+    std::atomic<double> sumW{0.0};
+    std::atomic<double> sumWW{0.0};
+};
+
+}  // namespace solver
@@ -0,0 +1,94 @@
+// headers/solver/patterns.h
+#pragma once
+#include <array>
+#include <cstdint>
+
+// local patterns precomputed at compile time, what one number or two numbers sharing open cells force
+// a pair is described by the mines each still needs and how many open cells only the first sees,
+// both see and only the second sees, which is all that matters for what they force,
+// so 1-2-1, 1-2-2-1 and the 1-1 against a wall are all single lookups
+namespace solver {
+
+enum PatternForce : uint8_t {
+    FORCE_ONLY_A_SAFE = 1 << 0,
+    FORCE_ONLY_A_MINE = 1 << 1,
+    FORCE_SHARED_SAFE = 1 << 2,
+    FORCE_SHARED_MINE = 1 << 3,
+    FORCE_ONLY_B_SAFE = 1 << 4,
+    FORCE_ONLY_B_MINE = 1 << 5,
+    FORCE_CONTRADICTION = 1 << 6,  // no placement fits, a wrong flag somewhere
+};
+
+// a number sees at most 8 cells, so every count fits 0..8
+constexpr int PATTERN_COUNTS = 9;
+
+constexpr int packPattern(int needA, int needB, int onlyA, int shared, int onlyB) {
+    return (((needA * PATTERN_COUNTS + needB) * PATTERN_COUNTS + onlyA) * PATTERN_COUNTS + shared) * PATTERN_COUNTS + onlyB;
+}
+
+// for every mine count k the shared cells could hold, the rest of each number has to fit its own cells
+constexpr uint8_t forcePattern(int needA, int needB, int onlyA, int shared, int onlyB) {
+    bool any = false;
+    bool aClear = true, aFull = true, sClear = true, sFull = true, bClear = true, bFull = true;
+    for (int k = 0; k <= shared; ++k) {
+        int restA = needA - k;
+        int restB = needB - k;
+        if (restA < 0 || restA > onlyA || restB < 0 || restB > onlyB)
+            continue;
+        any = true;
+        aClear = aClear && restA == 0;
+        aFull = aFull && restA == onlyA;
+        sClear = sClear && k == 0;
+        sFull = sFull && k == shared;
+        bClear = bClear && restB == 0;
+        bFull = bFull && restB == onlyB;
+    }
+    if (!any)
+        return FORCE_CONTRADICTION;
+
+    // an empty part is trivially both, it says nothing
+    uint8_t forces = 0;
+    if (onlyA > 0)
+        forces |= (aClear ? FORCE_ONLY_A_SAFE : 0) | (aFull ? FORCE_ONLY_A_MINE : 0);
+    if (shared > 0)
+        forces |= (sClear ? FORCE_SHARED_SAFE : 0) | (sFull ? FORCE_SHARED_MINE : 0);
+    if (onlyB > 0)
+        forces |= (bClear ? FORCE_ONLY_B_SAFE : 0) | (bFull ? FORCE_ONLY_B_MINE : 0);
+    return forces;
+}
+
+constexpr std::array<uint8_t, packPattern(PATTERN_COUNTS, 0, 0, 0, 0)> makePatternTable() {
+    std::array<uint8_t, packPattern(PATTERN_COUNTS, 0, 0, 0, 0)> table{};
+    for (int needA = 0; needA < PATTERN_COUNTS; ++needA)
+        for (int needB = 0; needB < PATTERN_COUNTS; ++needB)
+            for (int onlyA = 0; onlyA < PATTERN_COUNTS; ++onlyA)
+                for (int shared = 0; shared < PATTERN_COUNTS; ++shared)
+                    for (int onlyB = 0; onlyB < PATTERN_COUNTS; ++onlyB)
+                        table[packPattern(needA, needB, onlyA, shared, onlyB)] =
+                            forcePattern(needA, needB, onlyA, shared, onlyB);
+    return table;
+}
+
+inline constexpr auto PATTERN_TABLE = makePatternTable();
+
+// one number alone is a pair with nothing shared
+inline uint8_t lookupPattern(int needA, int needB, int onlyA, int shared, int onlyB) {
+    if (needA < 0 || needA >= PATTERN_COUNTS || needB < 0 || needB >= PATTERN_COUNTS)
+        return FORCE_CONTRADICTION;
+    return PATTERN_TABLE[packPattern(needA, needB, onlyA, shared, onlyB)];
+}
+
+// the named patterns, along a wall each number sees the three cells below it
+// 1-1 from a corner, the first 1 sees two cells, the second 1 one more, which is safe
+static_assert(PATTERN_TABLE[packPattern(1, 1, 0, 2, 1)] == FORCE_ONLY_B_SAFE);
+// 1-2 inside 1-2-1, the cell only the 2 sees is a mine and the cell only the 1 sees is safe
+static_assert(PATTERN_TABLE[packPattern(1, 2, 1, 2, 1)] == (FORCE_ONLY_A_SAFE | FORCE_ONLY_B_MINE));
+// 2-1 inside 1-2-1, mirrored
+static_assert(PATTERN_TABLE[packPattern(2, 1, 1, 2, 1)] == (FORCE_ONLY_A_MINE | FORCE_ONLY_B_SAFE));
+// 1-2 at either end of 1-2-2-1 is the same lookup as above, the 2-2 in the middle forces nothing alone
+static_assert(PATTERN_TABLE[packPattern(2, 2, 1, 2, 1)] == 0);
+// a satisfied number clears its cells, one with as many open cells as mines needed fills them
+static_assert(PATTERN_TABLE[packPattern(0, 0, 3, 0, 0)] == FORCE_ONLY_A_SAFE);
+static_assert(PATTERN_TABLE[packPattern(3, 0, 3, 0, 0)] == FORCE_ONLY_A_MINE);
+
+}  // namespace solver
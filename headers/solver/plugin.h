@@ -0,0 +1,79 @@
+// headers/solver/plugin.h
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/solver/pluginabi.h"
+#include "headers/solver/probability.h"
+
+namespace solver {
+
+// a solver library loaded with dlopen or LoadLibrary, shared by every PluginSolver made from it
+// errors throw std::runtime_error, a missing entry point or another abi version is refused at load
+class SolverPlugin {
+   public:
+    explicit SolverPlugin(const std::string& path);
+    ~SolverPlugin();
+    SolverPlugin(const SolverPlugin&) = delete;
+    SolverPlugin& operator=(const SolverPlugin&) = delete;
+
+    const dansweeper_solver_plugin& api() const { return *entry; }
+    std::string name() const;
+
+   private:
+    void* library = nullptr;
+    const dansweeper_solver_plugin* entry = nullptr;
+};
+
+// host timing of next_moves alone, the view refresh and move conversion are left out
+struct PluginCallStats {
+    uint64_t calls = 0;
+    uint64_t overBudget = 0;
+    uint64_t lastNanoseconds = 0;
+    uint64_t maxNanoseconds = 0;
+    uint64_t totalNanoseconds = 0;
+    uint64_t droppedMoves = 0;  // off the board, or on a cell already revealed or flagged
+};
+
+// one plugin solver on one grid, answers like the built in solvers so callers apply moves the same way
+// the plugin sees a copy of the visible tiles kept in step through the grid's listener, never the cells themselves
+class PluginSolver : public GridListener {
+   public:
+    PluginSolver(const SolverPlugin& plugin, Grid* grid, uint64_t seed);
+    ~PluginSolver() override;
+    PluginSolver(const PluginSolver&) = delete;
+    PluginSolver& operator=(const PluginSolver&) = delete;
+
+    // safe and mine moves come back as certain, the first guess as bestGuess, nothing at all when the plugin gives up
+    // only moves on open cells are kept, anything else is counted in stats.droppedMoves
+    ProbabilityMap solve(std::chrono::nanoseconds budget);
+
+    void onCellChanged(int x, int y) override;
+    void onBoardChanged() override;
+
+    PluginCallStats stats;
+
+    // moves one call may return, the rest of a longer list is cut off
+    static constexpr int32_t MOVE_CAPACITY = 4096;
+
+   private:
+    void refreshView();
+    void copyChunk(size_t index);
+
+    const SolverPlugin& plugin;
+    Grid* grid;
+    void* state = nullptr;
+    dansweeper_board_view view{};
+    std::vector<dansweeper_move> moves;
+
+    // one tile byte per cell of every touched chunk in the grid's cell layout, what view.chunks points at
+    std::vector<std::unique_ptr<uint8_t[]>> planes;
+    std::vector<const void*> planeTable;
+    bool allDirty = true;
+};
+
+}  // namespace solver
@@ -0,0 +1,109 @@
+// headers/solver/pluginabi.h
+#pragma once
+#include <stdint.h>
+
+// c abi for solvers built as shared libraries and loaded at runtime, see solver::SolverPlugin for the host side
+// a plugin exports dansweeper_solver_plugin_entry, which returns a table of functions that lives as long as the library
+//
+// the board view holds the visible tiles and nothing else, whether a hidden cell is a mine can't be read through it
+// the host keeps its own copy of the tiles in step with the game as cells change, so nothing is copied per call
+// and a plugin can't read ahead of what a player sees, chunks appear in the table as the game touches them
+// a plugin still runs in the host process, anything built to dig through the host's memory can't be stopped here
+//
+// create, destroy and next_moves may run on several threads at once for different solvers, never for the same one
+
+#if defined(_WIN32)
+#define DANSWEEPER_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define DANSWEEPER_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// bumped whenever a struct below changes, the host refuses plugins built against another version
+#define DANSWEEPER_PLUGIN_ABI_VERSION 1
+
+// visible tile values, same as TileId
+enum {
+    DANSWEEPER_TILE_1 = 0,  // numbers 1..8 are DANSWEEPER_TILE_1 + n - 1
+    DANSWEEPER_TILE_8 = 7,
+    DANSWEEPER_TILE_REVEALED = 8,  // revealed with no mines around
+    DANSWEEPER_TILE_BLANK = 9,     // not revealed
+    DANSWEEPER_TILE_FLAG = 10,
+    DANSWEEPER_TILE_QUESTION = 13,
+};
+
+enum {
+    DANSWEEPER_LAYOUT_ROW_MAJOR = 0,
+    DANSWEEPER_LAYOUT_MORTON = 1,  // x bits on even positions, y bits on odd ones
+};
+
+enum {
+    DANSWEEPER_MOVE_SAFE = 0,   // reveal a cell known to be safe
+    DANSWEEPER_MOVE_MINE = 1,   // flag a cell known to be a mine
+    DANSWEEPER_MOVE_GUESS = 2,  // reveal a cell that might be a mine, only the first guess of a call is played
+};
+
+typedef struct dansweeper_board_view {
+    int32_t width;
+    int32_t height;
+    int32_t mines;
+    int32_t game_state;  // 0 ongoing, 1 won, 2 lost
+
+    int32_t chunk_size;  // cells per chunk side
+    int32_t chunks_wide;
+    int32_t chunks_high;
+    int32_t cell_layout;  // order of cells inside a chunk
+    int32_t cell_bytes;   // stride between cells, 1 from this host
+    int32_t tile_offset;  // visible tile byte inside a cell, 0 from this host
+    const void* const* chunks;  // chunks_wide * chunks_high in row order, null while untouched, every tile blank
+
+    uint64_t visible_hash;  // equal hashes are equal boards, cheap to skip work when nothing changed
+} dansweeper_board_view;
+
+typedef struct dansweeper_move {
+    int32_t x;
+    int32_t y;
+    int32_t kind;
+} dansweeper_move;
+
+typedef struct dansweeper_solver_plugin {
+    uint32_t abi_version;  // DANSWEEPER_PLUGIN_ABI_VERSION
+    const char* name;
+
+    // one solver per game, null on failure, seed is for any randomness so runs replay
+    void* (*create)(const dansweeper_board_view* board, uint64_t seed);
+    void (*destroy)(void* solver);
+
+    // fills up to capacity moves and returns how many, 0 gives the game up
+    // budget_ns is what the host allows per call, the host times every call and counts the ones over it
+    int32_t (*next_moves)(void* solver, const dansweeper_board_view* board, uint64_t budget_ns, dansweeper_move* moves,
+                          int32_t capacity);
+} dansweeper_solver_plugin;
+
+typedef const dansweeper_solver_plugin* (*dansweeper_solver_plugin_entry_fn)(void);
+#define DANSWEEPER_PLUGIN_ENTRY "dansweeper_solver_plugin_entry"
+
+// visible tile at x, y read in place
+static inline uint8_t dansweeper_board_tile(const dansweeper_board_view* board, int32_t x, int32_t y) {
+    int32_t size = board->chunk_size;
+    const uint8_t* chunk = (const uint8_t*)board->chunks[(y / size) * board->chunks_wide + x / size];
+    if (!chunk)
+        return DANSWEEPER_TILE_BLANK;
+
+    int32_t localX = x % size;
+    int32_t localY = y % size;
+    int32_t index = localY * size + localX;
+    if (board->cell_layout == DANSWEEPER_LAYOUT_MORTON) {
+        index = 0;
+        for (int32_t bit = 0; (1 << bit) < size; ++bit)
+            index |= (((localX >> bit) & 1) << (bit * 2)) | (((localY >> bit) & 1) << (bit * 2 + 1));
+    }
+    return chunk[index * board->cell_bytes + board->tile_offset];
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+// headers/solver/probability.h
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/solver/constraints.h"
+#include "headers/solver/solver.h"
+
+namespace solver {
+
+class MonteCarloEstimator;
+class TranspositionCache;
+
+struct ProbabilityMap {
+    std::unordered_map<int64_t, double> frontier;  // mine probability per open cell next to a number
+    double interiorProbability = 0.0;              // every other open cell shares this one
+    int64_t interiorCells = 0;
+    bool exact = true;     // false once any component had to be sampled
+    uint64_t samples = 0;  // fillings drawn for sampled components
+
+    Deductions certain;  // probability exactly 0 or 1
+    CellPos bestGuess = {-1, -1};
+    double bestGuessProbability = 1.0;
+};
+
+// exact mine probability for every unrevealed cell, using the global mine count
+// components are enumerated in parallel and cached by a canonical hash of their rules,
+// so a reveal only re-solves the components it actually changed
+// components too big to enumerate in time fall back to sampling, see ConstraintEngine::sample
+class ProbabilitySolver : public GridListener {
+   public:
+    explicit ProbabilitySolver(Grid* grid);
+    ~ProbabilitySolver() override;
+    ProbabilitySolver(const ProbabilitySolver&) = delete;
+    ProbabilitySolver& operator=(const ProbabilitySolver&) = delete;
+
+    ProbabilityMap solve();
+    // half the budget goes to exact enumeration smallest component first, the rest to sampling what is left
+    ProbabilityMap solveWithin(std::chrono::microseconds budget);
+
+    // enumeration nodes allowed per component before it is sampled instead
+    uint64_t nodeBudget = 50'000'000;
+    // samples per component when solve() runs out of nodes, solveWithin samples until its deadline
+    uint64_t fallbackSamples = 100'000;
+    // components at least this big are solved on their own thread
+    size_t parallelThreshold = 24;
+
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+
+    // optional, shares boards and components with other solvers and later games
+    TranspositionCache* transpositions = nullptr;
+    // optional, samples components too big to enumerate on a pool of threads instead of this one
+    MonteCarloEstimator* sampler = nullptr;
+    // with a sampler, a component stops once its worst standard error is under this, 0 samples to the deadline
+    double sampleTarget = 0.0;
+
+    // components handed to the sampler so far and how far they got, see SampleStats
+    // errors only count components that got the two batches an error needs
+    size_t sampledComponents = 0;
+    size_t convergedComponents = 0;
+    size_t measuredComponents = 0;
+    uint64_t sampledDescents = 0;
+    double sampleErrorSum = 0.0;
+    double worstSampleError = 0.0;
+
+    void onCellChanged(int x, int y) override;
+    void onBoardChanged() override;
+
+   private:
+    ProbabilityMap solveUntil(Deadline deadline);
+    std::vector<Component> buildComponents(std::vector<int64_t>& frontierCells);
+    void refreshConstraint(int x, int y);
+    CellPos findInteriorCell(const std::vector<int64_t>& frontierCells);
+    void rescan();
+
+    Grid* grid;
+    std::unordered_set<int64_t> constraintCells;  // revealed numbers that still touch an open cell
+    std::unordered_set<int64_t> flaggedCells;
+    std::unordered_map<uint64_t, ComponentSolution> cache;  // exact solutions only
+    std::mt19937_64 rng{0x5eed};
+};
+
+uint64_t hashComponent(const Component& component);
+
+}  // namespace solver
@@ -0,0 +1,65 @@
+// headers/solver/singlepoint.h
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/solver/solver.h"
+
+namespace solver {
+
+// what single numbers and pairs of nearby numbers force, the moves a player finds without any guessing
+// each pair is one lookup in the compile time pattern table, see patterns.h
+// only reads what a SolverView shows a player, flags are trusted as mines
+// listens to the grid so each call only looks at numbers near cells that changed since the last one
+class SinglePointSolver : public GridListener {
+   public:
+    explicit SinglePointSolver(Grid* grid);
+    ~SinglePointSolver() override;
+    SinglePointSolver(const SinglePointSolver&) = delete;
+    SinglePointSolver& operator=(const SinglePointSolver&) = delete;
+
+    // runs the rules to a fixpoint over the dirty frontier, returns cells newly found this call
+    Deductions solve();
+    // stops once deadline passes, what is left of the frontier waits for the next call, see pending()
+    Deductions solve(std::chrono::steady_clock::time_point deadline);
+    bool pending() const { return !worklist.empty(); }
+
+    bool isKnownMine(int x, int y) const;
+    bool isKnownSafe(int x, int y) const;
+
+    // 7x7 cells around a number as bits, enough for every number in its 5x5 and their neighbours
+    static constexpr int WINDOW_REACH = 3;
+    static constexpr int WINDOW_SIZE = WINDOW_REACH * 2 + 1;
+    static constexpr int windowBit(int dx, int dy) { return (dy + WINDOW_REACH) * WINDOW_SIZE + dx + WINDOW_REACH; }
+
+    void onCellChanged(int x, int y) override;
+    void onBoardChanged() override;
+
+   private:
+    struct Window {
+        uint64_t open = 0;   // neither revealed, flagged nor deduced
+        uint64_t mines = 0;  // flagged or deduced mines
+        std::array<int8_t, WINDOW_SIZE * WINDOW_SIZE> numbers;  // revealed numbers in the inner 5x5, -1 elsewhere
+    };
+
+    void readWindow(int x, int y, int reach, Window& window);
+    bool applyPattern(int x, int y, uint8_t forces, uint64_t onlyCenter, uint64_t shared, uint64_t onlyOther,
+                      Deductions& result);
+    void markSafe(int64_t key, Deductions& result);
+    void markMine(int64_t key, Deductions& result);
+    void enqueueAround(int x, int y);
+    void rescan();
+
+    Grid* grid;
+    std::deque<int64_t> worklist;
+    std::unordered_set<int64_t> queued;
+    std::unordered_set<int64_t> deducedSafe;
+    std::unordered_set<int64_t> deducedMines;
+};
+
+}  // namespace solver
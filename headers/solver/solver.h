@@ -0,0 +1,28 @@
+// headers/solver/solver.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// shared types for the solvers in src/solver/
+// solvers only report what they found, applying moves to the grid is up to the caller
+namespace solver {
+
+struct CellPos {
+    int x;
+    int y;
+
+    bool operator==(const CellPos&) const = default;
+};
+
+struct Deductions {
+    std::vector<CellPos> safe;
+    std::vector<CellPos> mines;
+
+    bool empty() const { return safe.empty() && mines.empty(); }
+};
+
+inline int64_t cellKey(int x, int y, int width) {
+    return static_cast<int64_t>(y) * width + x;
+}
+
+}  // namespace solver
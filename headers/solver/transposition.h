@@ -0,0 +1,48 @@
+// headers/solver/transposition.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "headers/solver/constraints.h"
+#include "headers/solver/probability.h"
+
+namespace solver {
+
+// solver results keyed by position, shared between solvers, grids and threads
+// boards are keyed by Grid::visibleHash, components by hashComponent, both survive across games
+// oldest entries are dropped once a table holds capacity entries
+class TranspositionCache {
+   public:
+    explicit TranspositionCache(size_t capacity = 1 << 16);
+
+    bool findBoard(uint64_t hash, ProbabilityMap& result);
+    void storeBoard(uint64_t hash, const ProbabilityMap& result);
+    bool findComponent(uint64_t hash, ComponentSolution& result);
+    void storeComponent(uint64_t hash, const ComponentSolution& result);
+    void clear();
+
+    size_t boardHits = 0;
+    size_t boardMisses = 0;
+    size_t componentHits = 0;
+    size_t componentMisses = 0;
+
+   private:
+    template <typename Value>
+    struct Table {
+        std::unordered_map<uint64_t, Value> entries;
+        std::deque<uint64_t> age;
+    };
+
+    template <typename Value>
+    void store(Table<Value>& table, uint64_t hash, const Value& value);
+
+    size_t capacity;
+    std::mutex mutex;
+    Table<ProbabilityMap> boards;
+    Table<ComponentSolution> components;
+};
+
+}  // namespace solver
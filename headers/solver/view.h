@@ -0,0 +1,184 @@
+// headers/solver/view.h
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "headers/grid.h"
+
+// what a player can see of a grid and nothing else, read in place from the chunk storage
+// every answer comes from a cell's renderTile, the byte the game draws, so mines and unresolved counts under it
+// can't be reached through a view, and reading never creates chunks or resolves anything
+// untouched chunks read as blank, after a loss the game draws their mines through Grid::tileAt but a view doesn't
+namespace solver {
+
+// number a tile shows, 0 for an empty revealed cell, -1 for anything that isn't a revealed number
+constexpr std::array<int8_t, 16> makeTileNumbers() {
+    std::array<int8_t, 16> numbers{};
+    numbers.fill(-1);
+    for (int tile = TILE_1; tile <= TILE_8; ++tile)
+        numbers[tile] = static_cast<int8_t>(tile - TILE_1 + 1);
+    numbers[TILE_REVEALED] = 0;
+    return numbers;
+}
+inline constexpr std::array<int8_t, 16> TILE_NUMBERS = makeTileNumbers();
+
+// neither revealed nor flagged
+inline bool isOpenTile(TileId tile) {
+    return tile == TILE_BLANK || tile == TILE_QUESTION || tile == TILE_QUESTION_REVEALED;
+}
+
+// flags, and mines once a loss shows them, solvers count both as mines
+inline bool isMarkedTile(TileId tile) {
+    return tile == TILE_FLAG || tile == TILE_MINE_WRONG || tile == TILE_MINE_REVEALED || tile == TILE_MINE_HIT;
+}
+
+// cells are 5 bytes, so 8 cells are exactly 5 words
+inline constexpr int TILE_GROUP = 8;
+inline constexpr int TILE_GROUP_WORDS = TILE_GROUP * sizeof(Cell) / sizeof(uint64_t);
+static_assert(TILE_GROUP * sizeof(Cell) == TILE_GROUP_WORDS * sizeof(uint64_t));
+
+// value in the renderTile byte of each of 8 cells and zero in every other byte
+constexpr std::array<uint64_t, TILE_GROUP_WORDS> makeGroupTiles(uint8_t value) {
+    std::array<uint64_t, TILE_GROUP_WORDS> words{};
+    for (size_t cell = 0; cell < TILE_GROUP; ++cell) {
+        size_t byte = cell * sizeof(Cell) + offsetof(Cell, renderTile);
+        size_t shift = std::endian::native == std::endian::little ? byte % 8 : 7 - byte % 8;
+        words[byte / 8] |= uint64_t(value) << (shift * 8);
+    }
+    return words;
+}
+inline constexpr std::array<uint64_t, TILE_GROUP_WORDS> GROUP_TILE_MASKS = makeGroupTiles(0xff);
+inline constexpr std::array<uint64_t, TILE_GROUP_WORDS> BLANK_GROUP_TILES = makeGroupTiles(TILE_BLANK);
+
+// up to CHUNK_SIZE tiles of one row inside one chunk, index 0 is the chunk's first column
+class TileSpan {
+   public:
+    int firstX = 0;
+    int size = 0;
+
+    bool untouched() const { return cells == BLANK_ROW.data(); }  // every tile blank
+
+    TileId operator[](int i) const { return cells[(morton ? MORTON_SPREAD[i] : i) | rowBits].renderTile; }
+
+    // visit(i, tile) for every tile in order, the layout is picked once so row major spans are a plain array walk
+    template <typename Visit>
+    void forEach(Visit&& visit) const {
+        if (!morton) {
+            const Cell* row = cells + rowBits;
+            for (int i = 0; i < size; ++i)
+                visit(i, row[i].renderTile);
+        } else {
+            for (int i = 0; i < size; ++i)
+                visit(i, cells[MORTON_SPREAD[i] | rowBits].renderTile);
+        }
+    }
+
+    // true when every tile in [first, first + count) is blank, in row major chunks 8 are checked with 5 loads
+    bool allBlank(int first, int count) const {
+        if (untouched())
+            return true;
+        if (!morton && count == TILE_GROUP) {
+            uint64_t packed[TILE_GROUP_WORDS];
+            std::memcpy(packed, &cells[first | rowBits], sizeof(packed));
+            uint64_t differ = 0;
+            for (int i = 0; i < TILE_GROUP_WORDS; ++i)
+                differ |= (packed[i] ^ BLANK_GROUP_TILES[i]) & GROUP_TILE_MASKS[i];
+            return differ == 0;
+        }
+        for (int i = first; i < first + count; ++i)
+            if ((*this)[i] != TILE_BLANK)
+                return false;
+        return true;
+    }
+
+   private:
+    friend class SolverView;
+
+    // untouched spans read this row, so indexing never has to check for a missing chunk
+    static inline const std::array<Cell, CHUNK_SIZE> BLANK_ROW{};
+
+    const Cell* cells = BLANK_ROW.data();
+    int rowBits = 0;  // the row's part of a cell index, ored with the column's
+    bool morton = false;
+};
+
+// cheap to build, holds the grid's chunk table and size, so make one per call rather than keeping it
+// across a regeneration
+class SolverView {
+   public:
+    explicit SolverView(const Grid& grid)
+        : table(grid.chunks.tableData()),
+          gridWidth(grid.width),
+          gridHeight(grid.height),
+          chunksWide(grid.chunksWide),
+          chunksHigh(grid.chunksHigh),
+          layout(grid.cellLayout) {}
+
+    int width() const { return gridWidth; }
+    int height() const { return gridHeight; }
+    int chunkColumns() const { return chunksWide; }
+    int chunkRows() const { return chunksHigh; }
+    bool inBounds(int x, int y) const { return x >= 0 && x < gridWidth && y >= 0 && y < gridHeight; }
+
+    // nothing inside an untouched chunk is revealed or flagged
+    bool chunkTouched(int chunkX, int chunkY) const { return table[chunkY * chunksWide + chunkX] != nullptr; }
+
+    TileId tile(int x, int y) const {
+        const Chunk* chunk = table[(y / CHUNK_SIZE) * chunksWide + x / CHUNK_SIZE];
+        if (!chunk)
+            return TILE_BLANK;
+        return chunk->cells[chunkCellIndex(layout, x % CHUNK_SIZE, y % CHUNK_SIZE)].renderTile;
+    }
+
+    bool isOpen(int x, int y) const { return isOpenTile(tile(x, y)); }
+    bool isMarked(int x, int y) const { return isMarkedTile(tile(x, y)); }
+    bool isFlagged(int x, int y) const { return tile(x, y) == TILE_FLAG; }
+    int number(int x, int y) const { return TILE_NUMBERS[tile(x, y)]; }
+
+    // row y of chunk column chunkX, size trimmed at the board's right edge
+    TileSpan row(int y, int chunkX) const {
+        TileSpan span;
+        span.firstX = chunkX * CHUNK_SIZE;
+        span.size = std::min(CHUNK_SIZE, gridWidth - span.firstX);
+        const Chunk* chunk = table[(y / CHUNK_SIZE) * chunksWide + chunkX];
+        if (chunk) {
+            int localY = y % CHUNK_SIZE;
+            span.cells = chunk->cells.data();
+            span.morton = layout == CellLayout::MORTON;
+            span.rowBits = span.morton ? MORTON_SPREAD[localY] << 1 : localY * CHUNK_SIZE;
+        }
+        return span;
+    }
+
+    // visit(x, y, tile) for the rectangle [x0, x1) x [y0, y1), clipped to the board, a row span at a time
+    template <typename Visit>
+    void forEachTile(int x0, int y0, int x1, int y1, Visit&& visit) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, gridWidth);
+        y1 = std::min(y1, gridHeight);
+        for (int y = y0; y < y1; ++y) {
+            for (int chunkX = x0 / CHUNK_SIZE; chunkX * CHUNK_SIZE < x1; ++chunkX) {
+                TileSpan span = row(y, chunkX);
+                int from = std::max(x0, span.firstX) - span.firstX;
+                int to = std::min(x1, span.firstX + span.size) - span.firstX;
+                for (int i = from; i < to; ++i)
+                    visit(span.firstX + i, y, span[i]);
+            }
+        }
+    }
+
+   private:
+    Chunk* const* table;
+    int gridWidth;
+    int gridHeight;
+    int chunksWide;
+    int chunksHigh;
+    CellLayout layout;
+};
+
+}  // namespace solver
@@ -1,9 +1,10 @@
 #pragma once
+#include <cstdint>
 
 const int TILE_TEXTURE_PIXEL_SIZE = 16;
 const int TILESET_COLS = 4;
 
-enum TileId {
+enum TileId : uint8_t {
     TILE_1 = 0,
     TILE_2 = 1,
     TILE_3 = 2,
@@ -1,20 +1,50 @@
 #pragma once
 #include <array>
+#include <cstdint>
+#include <random>
+#include <string>
 #include <vector>
 
-#include "headers/grid.h"
+#include "headers/tile.h"
+
+struct GridMetadata;
 
 namespace gridutils {
 // encoding
 std::string createSeedFromManualInput(uint16_t width, uint16_t height, uint32_t numMines, uint16_t safeX, uint16_t safeY, uint64_t prngSeed);
-std::string encodeBase64(const std::vector<uint8_t>& data);
+std::string encodeBase64(const uint8_t* data, size_t length);
 std::string createBase64Seed(uint16_t width, uint16_t height, uint32_t numMines, uint16_t safeX, uint16_t safeY, uint64_t prngSeed);
 
+uint64_t deriveFreshSeed(uint16_t width, uint16_t height, uint32_t numMines, uint16_t safeX, uint16_t safeY, uint64_t timeNs);
+
 // decoding
 GridMetadata decodeSeed(const std::string& seed);
 std::vector<uint8_t> decodeBase64Bytes(const std::string& encoded);
 std::array<int, 256> makeBase64ReverseMap();
 
+// portable random draws
+// std distributions and std::shuffle are implementation defined, these give the same board on every toolchain
+uint64_t uniformInt(std::mt19937_64& gen, uint64_t min, uint64_t max);
+
+// keyed bijection over [0, population), feistel rounds with cycle walking
+// mine placement asks "is this index one of the first numMine in the permutation", so any cell or
+// chunk of the board can be generated on its own with nothing stored
+struct IndexPermutation {
+    uint64_t population = 0;
+    int halfBits = 1;
+    uint64_t halfMask = 1;
+    std::array<uint64_t, 6> roundKeys{};
+};
+IndexPermutation makeIndexPermutation(uint64_t population, uint64_t seed);
+uint64_t permuteIndex(const IndexPermutation& permutation, uint64_t index);
+// the index permuteIndex sends to a given value, placing every mine of a small board is then one call per mine
+uint64_t unpermuteIndex(const IndexPermutation& permutation, uint64_t value);
+
+// zobrist keys for the player visible board, xor of every cell's key for the tile it shows
+// blank cells contribute nothing, so an untouched board hashes to its base key alone
+uint64_t zobristBase(int width, int height, int64_t numMines);
+uint64_t zobristKey(int64_t cellIndex, TileId tile);
+
 // validate metadata
 GridMetadata validateMetadata(uint16_t width, uint16_t height, uint32_t numMines, uint64_t prngSeed, uint16_t safeX, uint16_t safeY);
 
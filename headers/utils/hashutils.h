@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// fixed, toolchain independent hashing
+// std::hash differs between libstdc++, libc++ and msvc so it can't be used for anything seeded
+namespace hashutils {
+// xxh64, same output on every platform for the same bytes
+uint64_t xxh64(const void* data, size_t length, uint64_t seed = 0);
+uint64_t hashString(const std::string& text, uint64_t seed = 0);
+
+}  // namespace hashutils
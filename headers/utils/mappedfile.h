@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// read/write file mapping, posix mmap or win32 file mappings
+// errors throw std::runtime_error like the rest of the seed/file handling
+class MappedFile {
+   public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // create truncates to a sparse file of `size` bytes, otherwise the existing file is mapped whole
+    void open(const std::string& path, size_t size, bool create);
+    void close();
+    void flush();
+
+    uint8_t* data() const;
+    size_t size() const;
+    bool isOpen() const;
+
+    static size_t pageSize();
+
+   private:
+    uint8_t* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
@@ -0,0 +1,113 @@
+#include "headers/chunkstore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(std::is_trivially_destructible_v<Chunk>, "mapped chunks are never destroyed");
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void ChunkStore::allocateHeap(size_t chunkCount) {
+    file.close();
+    stateBytes = nullptr;
+    slots = nullptr;
+
+    heapChunks.clear();
+    heapChunks.resize(chunkCount);
+    table.assign(chunkCount, nullptr);
+}
+
+void ChunkStore::createBackingFile(const std::string& path, size_t chunkCount) {
+    heapChunks.clear();
+
+    size_t page = MappedFile::pageSize();
+    size_t headerBytes = alignUp(sizeof(BackingFileHeader), page);
+    size_t stateBytesSize = alignUp(chunkCount, page);
+    this->slotBytes = alignUp(sizeof(Chunk), page);
+
+    file.open(path, headerBytes + stateBytesSize + chunkCount * slotBytes, true);
+
+    BackingFileHeader* h = header();
+    std::memcpy(h->magic, BACKING_FILE_MAGIC, sizeof(h->magic));
+    h->version = BACKING_FILE_VERSION;
+    h->pageSize = static_cast<uint32_t>(page);
+    h->chunkCount = chunkCount;
+    h->slotBytes = slotBytes;
+    h->stateOffset = headerBytes;
+    h->slotsOffset = headerBytes + stateBytesSize;
+
+    stateBytes = file.data() + h->stateOffset;
+    slots = file.data() + h->slotsOffset;
+    table.assign(chunkCount, nullptr);
+}
+
+void ChunkStore::openBackingFile(const std::string& path) {
+    heapChunks.clear();
+    file.open(path, 0, false);
+
+    if (file.size() < sizeof(BackingFileHeader))
+        throw std::runtime_error("Backing file too small: " + path);
+
+    BackingFileHeader* h = header();
+    if (std::memcmp(h->magic, BACKING_FILE_MAGIC, sizeof(h->magic)) != 0 || h->version != BACKING_FILE_VERSION)
+        throw std::runtime_error("Not a dansweeper backing file: " + path);
+    if (h->slotBytes < sizeof(Chunk) || h->slotsOffset + h->chunkCount * h->slotBytes > file.size())
+        throw std::runtime_error("Backing file layout does not match: " + path);
+
+    this->slotBytes = h->slotBytes;
+    stateBytes = file.data() + h->stateOffset;
+    slots = file.data() + h->slotsOffset;
+
+    // only the state bytes are read, chunk pages fault in when the game touches them
+    table.assign(h->chunkCount, nullptr);
+    for (size_t i = 0; i < table.size(); ++i)
+        if (stateBytes[i])
+            table[i] = reinterpret_cast<Chunk*>(slots + i * slotBytes);
+}
+
+void ChunkStore::clear() {
+    std::fill(table.begin(), table.end(), nullptr);
+    for (std::unique_ptr<Chunk>& chunk : heapChunks)
+        chunk.reset();
+    if (stateBytes)
+        std::memset(stateBytes, 0, table.size());
+}
+
+Chunk* ChunkStore::create(size_t index) {
+    if (table[index])
+        return table[index];
+
+    if (isMapped()) {
+        table[index] = new (slots + index * slotBytes) Chunk();
+        stateBytes[index] = 1;
+    } else {
+        heapChunks[index] = std::make_unique<Chunk>();
+        table[index] = heapChunks[index].get();
+    }
+    return table[index];
+}
+
+size_t ChunkStore::chunkCount() const {
+    return table.size();
+}
+
+size_t ChunkStore::materializedCount() const {
+    return table.size() - std::count(table.begin(), table.end(), nullptr);
+}
+
+bool ChunkStore::isMapped() const {
+    return file.isOpen();
+}
+
+BackingFileHeader* ChunkStore::header() const {
+    return isMapped() ? reinterpret_cast<BackingFileHeader*>(file.data()) : nullptr;
+}
+
+void ChunkStore::flush() {
+    file.flush();
+}
@@ -2,34 +2,49 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
+#include <cstring>
 #include <ctime>
-#include <iomanip>
 #include <iostream>
 #include <queue>
 #include <random>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#ifndef DANSWEEPER_HEADLESS
 #include "headers/globals.h"
 #include "raylib.h"
+#endif
 
 // extremely messy grid seed generation handling
 #include "headers/utils/gridutils.h"
 
+// seconds on a monotonic clock, raylib's in the game and std::chrono when built headless
+static double currentTime() {
+#ifdef DANSWEEPER_HEADLESS
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+#else
+    return GetTime();
+#endif
+}
+
 // grid initialization
-Grid::Grid(GridMetadata& metadata, const std::string& seed32, bool useSeed) {
+Grid::Grid(GridMetadata& metadata, const std::string& seed32, bool useSeed, const GridStorageOptions& storage) {
     this->useSeed = useSeed;
+    this->backingFile = storage.backingFile;
+    this->cellLayout = storage.layout;
     if (!useSeed) {
         this->width = metadata.width;
         this->height = metadata.height;
         this->numMine = metadata.numMine;
         this->firstClick = true;
-        this->cells.resize(this->height, std::vector<Cell>(this->width));
+        this->initStorage();
+        this->persistState();
 
     } else {
         GridMetadata decodedMetadata = gridutils::decodeSeed(seed32);
@@ -42,57 +57,285 @@ Grid::Grid(GridMetadata& metadata, const std::string& seed32, bool useSeed) {
         this->seed32 = seed32;
         this->firstClick = true;
 
-        this->cells.resize(this->height, std::vector<Cell>(this->width));
         Grid::generateBoard();
     }
 }
 
-void Grid::generateBoard() {
-    // Reset all cells
-    for (int y = 0; y < height; ++y)
-        for (int x = 0; x < width; ++x) {
-            cells[y][x].content = CELL_EMPTY;
-            cells[y][x].renderTile = TILE_BLANK;
-            cells[y][x].revealed = false;
-            cells[y][x].flagged = false;
-            cells[y][x].adjacentMines = 0;
-        }
+Grid::Grid(const std::string& backingFile) {
+    this->backingFile = backingFile;
+    this->chunks.openBackingFile(backingFile);
+
+    const BackingFileHeader* header = chunks.header();
+    this->width = header->width;
+    this->height = header->height;
+    this->numMine = header->numMine;
+    this->prngSeed = header->prngSeed;
+    this->safeX = header->safeX;
+    this->safeY = header->safeY;
+    this->useSeed = header->useSeed;
+    this->firstClick = header->firstClick;
+    this->gameState = static_cast<GameState>(header->gameState);
+    this->cellLayout = static_cast<CellLayout>(header->cellLayout);
+    this->revealedSafeCells = header->revealedSafeCells;
+    this->seed32 = std::string(header->seed32, strnlen(header->seed32, sizeof(header->seed32)));
+
+    this->timeElapsed = header->timeElapsed;
+    this->endStats.timeElapsed = header->timeElapsed;
+    this->endStats.numFlagged = header->numFlagged;
+    this->endStats.numRevealed = header->numRevealed;
+    this->endStats.bombsLeft = header->bombsLeft;
+    this->endStats.width = this->width;
+    this->endStats.height = this->height;
+    this->endStats.seed32 = this->seed32;
+
+    this->chunksWide = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    this->chunksHigh = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (static_cast<size_t>(chunksWide) * chunksHigh != chunks.chunkCount())
+        throw std::runtime_error("Backing file chunk table does not match its board size");
+
+    if (header->boardGenerated)
+        initMinePermutation();
+    rehashVisibleState();
+
+    // carry on the clock from where it was suspended
+    this->startTime = currentTime() - timeElapsed;
+    this->timerRunning = !firstClick && gameState == GameState::ONGOING;
+}
 
-    // Generate list of all valid cells excluding the safe cell
-    std::vector<std::pair<int, int>> validCells;
-    for (int y = 0; y < height; ++y)
-        for (int x = 0; x < width; ++x)
-            if (!(x == safeX && y == safeY))
-                validCells.emplace_back(x, y);
+Grid::~Grid() {
+    persistState();
+}
 
-    std::mt19937_64 gen(prngSeed);
-    std::shuffle(validCells.begin(), validCells.end(), gen);
+void Grid::initStorage() {
+    this->chunksWide = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    this->chunksHigh = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    size_t chunkCount = static_cast<size_t>(chunksWide) * chunksHigh;
 
-    for (int i = 0; i < numMine && i < static_cast<int>(validCells.size()); ++i) {
-        int x = validCells[i].first;
-        int y = validCells[i].second;
-        cells[y][x].content = CELL_MINE;
+    if (chunks.chunkCount() == chunkCount) {
+        chunks.clear();
+    } else if (backingFile.empty()) {
+        chunks.allocateHeap(chunkCount);
+    } else {
+        chunks.createBackingFile(backingFile, chunkCount);
     }
+    this->visibleHash = gridutils::zobristBase(width, height, numMine);
+}
+
+void Grid::setTile(Cell& cell, int x, int y, TileId tile) {
+    int64_t index = static_cast<int64_t>(y) * width + x;
+    this->visibleHash ^= gridutils::zobristKey(index, cell.renderTile) ^ gridutils::zobristKey(index, tile);
+    cell.renderTile = tile;
+}
 
-    // Compute adjacent mine counts
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (cells[y][x].content == CELL_MINE)
+void Grid::rehashVisibleState() {
+    this->visibleHash = gridutils::zobristBase(width, height, numMine);
+    for (int chunkY = 0; chunkY < chunksHigh; ++chunkY) {
+        for (int chunkX = 0; chunkX < chunksWide; ++chunkX) {
+            const Chunk* chunk = findChunk(chunkX, chunkY);
+            if (!chunk)
                 continue;
 
-            int count = 0;
-            for (int dy = -1; dy <= 1; ++dy)
-                for (int dx = -1; dx <= 1; ++dx) {
-                    int nx = x + dx;
-                    int ny = y + dy;
-                    if (nx >= 0 && nx < width && ny >= 0 && ny < height &&
-                        cells[ny][nx].content == CELL_MINE)
-                        ++count;
+            for (int ly = 0; ly < CHUNK_SIZE && chunkY * CHUNK_SIZE + ly < height; ++ly) {
+                for (int lx = 0; lx < CHUNK_SIZE && chunkX * CHUNK_SIZE + lx < width; ++lx) {
+                    int64_t index = static_cast<int64_t>(chunkY * CHUNK_SIZE + ly) * width + chunkX * CHUNK_SIZE + lx;
+                    this->visibleHash ^= gridutils::zobristKey(index, chunk->cells[chunkCellIndex(cellLayout, lx, ly)].renderTile);
                 }
+            }
+        }
+    }
+}
+
+void Grid::initMinePermutation() {
+    // valid cells are every cell in row order with the safe cell skipped
+    bool hasSafeCell = validateCellInBounds(safeX, safeY);
+    uint64_t numValid = static_cast<uint64_t>(width) * height - (hasSafeCell ? 1 : 0);
+
+    this->totalMines = std::clamp<int64_t>(numMine, 0, static_cast<int64_t>(numValid));
+    this->minePermutation = gridutils::makeIndexPermutation(numValid, static_cast<uint64_t>(prngSeed));
+    this->boardGenerated = true;
+}
+
+void Grid::generateBoard() {
+    // drop anything touched so far, chunks are rebuilt from the permutation when next touched
+    initStorage();
+    initMinePermutation();
+    this->revealedSafeCells = 0;
+    persistState();
+    notifyBoardChanged();
+}
+
+bool Grid::isMine(int x, int y) const {
+    if (!boardGenerated || !validateCellInBounds(x, y))
+        return false;
 
-            cells[y][x].adjacentMines = count;
+    const Chunk* chunk = findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE);
+    if (chunk) {
+        return (chunk->mineRows[y % CHUNK_SIZE] >> (x % CHUNK_SIZE)) & 1ULL;
+    }
+
+    if (x == safeX && y == safeY)
+        return false;
+
+    uint64_t index = static_cast<uint64_t>(y) * width + x;
+    if (validateCellInBounds(safeX, safeY) && index > static_cast<uint64_t>(safeY) * width + safeX)
+        index--;
+
+    return gridutils::permuteIndex(minePermutation, index) < static_cast<uint64_t>(totalMines);
+}
+
+int Grid::countAdjacentMines(int x, int y) {
+    int count = 0;
+    for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx)
+            if ((dx != 0 || dy != 0) && isMine(x + dx, y + dy))
+                ++count;
+    return count;
+}
+
+int Grid::resolveAdjacentMines(int x, int y) {
+    Cell& cell = cellAt(x, y);
+    if (cell.adjacentMines != ADJACENT_UNRESOLVED)
+        return cell.adjacentMines;
+
+    if (cell.content == CELL_MINE) {
+        cell.adjacentMines = 0;
+        return 0;
+    }
+
+    int localX = x % CHUNK_SIZE;
+    int localY = y % CHUNK_SIZE;
+    if (localX > 0 && localX < CHUNK_SIZE - 1 && localY > 0 && localY < CHUNK_SIZE - 1) {
+        // whole neighbourhood inside this chunk, three masked row popcounts
+        const Chunk* chunk = findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE);
+        int count = 0;
+        for (int row = localY - 1; row <= localY + 1; ++row)
+            count += std::popcount((chunk->mineRows[row] >> (localX - 1)) & 7ULL);
+        cell.adjacentMines = count;
+    } else {
+        cell.adjacentMines = countAdjacentMines(x, y);
+    }
+
+    return cell.adjacentMines;
+}
+
+Chunk* Grid::materializeChunk(int chunkX, int chunkY) {
+    size_t index = static_cast<size_t>(chunkY) * chunksWide + chunkX;
+    if (Chunk* existing = chunks.find(index)) {
+        return existing;
+    }
+
+    // generate mine rows first, isMine would otherwise find this half built chunk
+    std::array<uint64_t, CHUNK_SIZE> mineRows{};
+    int originX = chunkX * CHUNK_SIZE;
+    int originY = chunkY * CHUNK_SIZE;
+    for (int ly = 0; ly < CHUNK_SIZE && originY + ly < height; ++ly)
+        for (int lx = 0; lx < CHUNK_SIZE && originX + lx < width; ++lx)
+            if (isMine(originX + lx, originY + ly))
+                mineRows[ly] |= 1ULL << lx;
+
+    Chunk* chunk = chunks.create(index);
+    chunk->mineRows = mineRows;
+    for (int ly = 0; ly < CHUNK_SIZE; ++ly) {
+        for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+            Cell& cell = chunk->cells[chunkCellIndex(cellLayout, lx, ly)];
+            cell.adjacentMines = ADJACENT_UNRESOLVED;
+            if ((mineRows[ly] >> lx) & 1ULL) {
+                cell.content = CELL_MINE;
+                // touched after a loss, mines show like everywhere else
+                if (gameState == GameState::LOST) {
+                    cell.revealed = true;
+                    setTile(cell, originX + lx, originY + ly, TILE_MINE_REVEALED);
+                }
+            }
         }
     }
+
+    return chunk;
+}
+
+const Chunk* Grid::findChunk(int chunkX, int chunkY) const {
+    return chunks.find(static_cast<size_t>(chunkY) * chunksWide + chunkX);
+}
+
+Cell& Grid::cellAt(int x, int y) {
+    Chunk* chunk = materializeChunk(x / CHUNK_SIZE, y / CHUNK_SIZE);
+    return chunk->cells[chunkCellIndex(cellLayout, x % CHUNK_SIZE, y % CHUNK_SIZE)];
+}
+
+const Cell* Grid::findCell(int x, int y) const {
+    const Chunk* chunk = findChunk(x / CHUNK_SIZE, y / CHUNK_SIZE);
+    if (!chunk) {
+        return nullptr;
+    }
+    return &chunk->cells[chunkCellIndex(cellLayout, x % CHUNK_SIZE, y % CHUNK_SIZE)];
+}
+
+TileId Grid::tileAt(int x, int y) const {
+    const Cell* cell = findCell(x, y);
+    if (cell) {
+        return cell->renderTile;
+    }
+
+    // untouched chunk, nothing revealed or flagged in it
+    if (gameState == GameState::LOST && isMine(x, y)) {
+        return TILE_MINE_REVEALED;
+    }
+    return TILE_BLANK;
+}
+
+size_t Grid::materializedChunks() const {
+    return chunks.materializedCount();
+}
+
+void Grid::addListener(GridListener* listener) {
+    listeners.push_back(listener);
+}
+
+void Grid::removeListener(GridListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+void Grid::notifyCellChanged(int x, int y) {
+    for (GridListener* listener : listeners)
+        listener->onCellChanged(x, y);
+}
+
+void Grid::notifyBoardChanged() {
+    for (GridListener* listener : listeners)
+        listener->onBoardChanged();
+}
+
+void Grid::persistState() {
+    BackingFileHeader* header = chunks.header();
+    if (!header) {
+        return;
+    }
+
+    header->width = width;
+    header->height = height;
+    header->numMine = numMine;
+    header->prngSeed = prngSeed;
+    header->safeX = safeX;
+    header->safeY = safeY;
+    header->useSeed = useSeed;
+    header->firstClick = firstClick;
+    header->boardGenerated = boardGenerated;
+    header->gameState = static_cast<uint8_t>(gameState);
+    header->cellLayout = static_cast<uint8_t>(cellLayout);
+    header->totalMines = totalMines;
+    header->revealedSafeCells = revealedSafeCells;
+    header->timeElapsed = timeElapsed;
+    header->numFlagged = endStats.numFlagged;
+    header->numRevealed = endStats.numRevealed;
+    header->bombsLeft = endStats.bombsLeft;
+
+    std::memset(header->seed32, 0, sizeof(header->seed32));
+    std::memcpy(header->seed32, seed32.data(), std::min(seed32.size(), sizeof(header->seed32) - 1));
+}
+
+void Grid::flushBackingFile() {
+    persistState();
+    chunks.flush();
 }
 
 void Grid::reveal(int startX, int startY) {
@@ -103,28 +346,18 @@ void Grid::reveal(int startX, int startY) {
         if (!this->useSeed) {
             // generate prngseed on click
             auto now = std::chrono::high_resolution_clock::now();
-            auto timeNs = now.time_since_epoch().count();
-
-            std::ostringstream saltStream;
-            saltStream << std::hex << timeNs;
+            uint64_t timeNs = static_cast<uint64_t>(now.time_since_epoch().count());
 
-            std::string salt = saltStream.str();
-
-            std::string fullKey = std::to_string(this->width) + "x" + std::to_string(this->height) +
-                                  ":" + std::to_string(this->numMine) +
-                                  ":" + std::to_string(this->safeX) + "," + std::to_string(this->safeY) +
-                                  ":" + salt;
-
-            std::hash<std::string> hasher;
-            this->prngSeed = hasher(fullKey);
             this->safeX = startX;
             this->safeY = startY;
+            this->prngSeed = gridutils::deriveFreshSeed(this->width, this->height, this->numMine, this->safeX, this->safeY, timeNs);
             this->seed32 = gridutils::createSeedFromManualInput(this->width, this->height, this->numMine, this->safeX, this->safeY, this->prngSeed);
             this->generateBoard();
         }
         this->firstClick = false;
-        this->startTime = GetTime();
+        this->startTime = currentTime();
         this->timerRunning = true;
+        this->persistState();
     }
 
     // bfs implementation of floodfill
@@ -132,7 +365,7 @@ void Grid::reveal(int startX, int startY) {
     if (startX < 0 || startX >= width || startY < 0 || startY >= height)
         return;
 
-    Cell& firstCell = cells[startY][startX];
+    Cell& firstCell = cellAt(startX, startY);
 
     if (firstCell.revealed || firstCell.flagged) {
         return;
@@ -140,28 +373,36 @@ void Grid::reveal(int startX, int startY) {
 
     if (firstCell.content == CELL_MINE) {
         gameState = GameState::LOST;
-        int remainingMines = 0;
-
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                Cell& cell = cells[y][x];
-                if (cell.content == CELL_MINE) {
-                    if (cell.flagged) {
-                        continue;
-                    } else if (!cell.flagged) {
-                        remainingMines++;
-                    }
-
-                    if (!cell.revealed) {
-                        cell.revealed = true;
-                        cell.renderTile = TILE_MINE_REVEALED;
+        int flaggedMines = 0;
+
+        // only touched chunks hold state, untouched ones show their mines through tileAt
+        for (int chunkY = 0; chunkY < chunksHigh; ++chunkY) {
+            for (int chunkX = 0; chunkX < chunksWide; ++chunkX) {
+                if (!findChunk(chunkX, chunkY))
+                    continue;
+
+                Chunk* chunk = materializeChunk(chunkX, chunkY);
+                for (Cell& cell : chunk->cells) {
+                    if (cell.content == CELL_MINE) {
+                        if (cell.flagged) {
+                            flaggedMines++;
+                            continue;
+                        }
+
+                        if (!cell.revealed) {
+                            cell.revealed = true;
+                            cell.renderTile = TILE_MINE_REVEALED;
+                        }
+                    } else if (cell.flagged) {
+                        cell.renderTile = TILE_MINE_WRONG;
                     }
-                } else if (cell.flagged) {
-                    cell.renderTile = TILE_MINE_WRONG;
                 }
             }
         }
-        cells[startY][startX].renderTile = TILE_MINE_HIT;
+        firstCell.renderTile = TILE_MINE_HIT;
+        // the whole board changed, cheaper to rehash the touched chunks than to track each tile
+        rehashVisibleState();
+        int remainingMines = static_cast<int>(totalMines - flaggedMines);
 
         this->endStats.bombsLeft = remainingMines;
         this->endStats.timeElapsed = this->timeElapsed;
@@ -169,34 +410,44 @@ void Grid::reveal(int startX, int startY) {
         this->endStats.width = this->width;
         this->endStats.seed32 = this->seed32;
 
+        persistState();
+        notifyBoardChanged();
         return;
     }
 
+    // cells are marked revealed when queued so each one goes through the queue once
     std::queue<std::pair<int, int>> toReveal;
+    firstCell.revealed = true;
     toReveal.push({startX, startY});
 
     while (!toReveal.empty()) {
         auto [x, y] = toReveal.front();
         toReveal.pop();
 
-        if (x < 0 || x >= width || y < 0 || y >= height)
-            continue;
+        Cell& cell = cellAt(x, y);
+        this->revealedSafeCells++;
 
-        Cell& cell = cells[y][x];
-        if (cell.revealed || cell.flagged)
-            continue;
-
-        cell.revealed = true;
+        if (resolveAdjacentMines(x, y) == 0) {
+            setTile(cell, x, y, TILE_REVEALED);
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    if ((dx == 0 && dy == 0) || !validateCellInBounds(nx, ny))
+                        continue;
 
-        if (cell.adjacentMines == 0) {
-            cell.renderTile = TILE_REVEALED;
-            for (int dy = -1; dy <= 1; ++dy)
-                for (int dx = -1; dx <= 1; ++dx)
-                    if (dx != 0 || dy != 0)
-                        toReveal.push({x + dx, y + dy});
+                    Cell& neighbor = cellAt(nx, ny);
+                    if (!neighbor.revealed && !neighbor.flagged) {
+                        neighbor.revealed = true;
+                        toReveal.push({nx, ny});
+                    }
+                }
+            }
         } else {
-            cell.renderTile = static_cast<TileId>(TILE_1 + (cell.adjacentMines - 1));
+            setTile(cell, x, y, static_cast<TileId>(TILE_1 + (cell.adjacentMines - 1)));
         }
+        // after the tile is set, listeners read what the player now sees
+        notifyCellChanged(x, y);
     }
 
     this->endStats.numRevealed++;
@@ -209,10 +460,16 @@ void Grid::reveal(int startX, int startY) {
         this->endStats.width = this->width;
         this->endStats.seed32 = this->seed32;
     }
+
+    persistState();
 }
 
 void Grid::chord(int x, int y) {
-    if (!cells[y][x].revealed || cells[y][x].adjacentMines == 0)
+    if (!validateCellInBounds(x, y))
+        return;
+
+    Cell& center = cellAt(x, y);
+    if (!center.revealed || center.adjacentMines == 0)
         return;
 
     int flagCount = 0;
@@ -224,13 +481,14 @@ void Grid::chord(int x, int y) {
             int ny = y + dy;
             if (dx == 0 && dy == 0) continue;
             if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                if (cells[ny][nx].flagged)
+                const Cell* neighbor = findCell(nx, ny);
+                if (neighbor && neighbor->flagged)
                     flagCount++;
             }
         }
     }
 
-    if (flagCount == cells[y][x].adjacentMines) {
+    if (flagCount == center.adjacentMines) {
         // Reveal surrounding cells that are not flagged
         for (int dy = -1; dy <= 1; ++dy) {
             for (int dx = -1; dx <= 1; ++dx) {
@@ -238,7 +496,7 @@ void Grid::chord(int x, int y) {
                 int ny = y + dy;
                 if (dx == 0 && dy == 0) continue;
                 if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                    Cell& neighbor = cells[ny][nx];
+                    Cell& neighbor = cellAt(nx, ny);
                     if (!neighbor.flagged && !neighbor.revealed) {
                         reveal(nx, ny);
                     }
@@ -252,24 +510,20 @@ void Grid::flag(int x, int y) {
     if (x < 0 || x >= width || y < 0 || y >= height)
         return;
 
-    if (cells[y][x].revealed == false) {
-        cells[y][x].flagged = (cells[y][x].flagged == true) ? false : true;
-        cells[y][x].renderTile = (cells[y][x].flagged == true) ? TILE_FLAG : TILE_BLANK;
+    Cell& cell = cellAt(x, y);
+    if (cell.revealed == false) {
+        cell.flagged = (cell.flagged == true) ? false : true;
+        setTile(cell, x, y, (cell.flagged == true) ? TILE_FLAG : TILE_BLANK);
         this->endStats.numFlagged++;
+        persistState();
+        notifyCellChanged(x, y);
     }
 }
 
 bool Grid::checkWinCondition() {
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            const Cell& cell = cells[y][x];
-            if (cell.content == CELL_EMPTY &&
-                (cell.renderTile == TILE_BLANK || cell.renderTile == TILE_FLAG || cell.renderTile == TILE_QUESTION)) {
-                return false;  // still unrevealed non-mine cell
-            }
-        }
-    }
-    return true;
+    // every non-mine cell revealed, counted as the flood fill goes instead of rescanning the board
+    int64_t safeCells = static_cast<int64_t>(width) * height - totalMines;
+    return boardGenerated && revealedSafeCells >= safeCells;
 }
 
 void Grid::updateTimer() {
@@ -277,25 +531,30 @@ void Grid::updateTimer() {
         return;
     }
 
+#ifdef DANSWEEPER_HEADLESS
+    timeElapsed = static_cast<float>(currentTime() - startTime);
+#else
     switch (windowState) {
         case WindowState::GAME: {
-            timeElapsed = static_cast<float>(GetTime() - startTime);
+            timeElapsed = static_cast<float>(currentTime() - startTime);
             break;
         }
 
         case WindowState::PAUSE: {
-            startTime = static_cast<float>(GetTime() - timeElapsed);
+            startTime = static_cast<float>(currentTime() - timeElapsed);
             break;
         }
 
         default:
             break;
     }
+#endif
 }
 
 Cell Grid::getCellProperties(int x, int y) {
     if (validateCellInBounds(x, y)) {
-        return this->cells[y][x];
+        resolveAdjacentMines(x, y);
+        return cellAt(x, y);
     }
     return {};
 }
@@ -308,7 +567,7 @@ int Grid::getGridHeight() {
     return this->height;
 }
 
-bool Grid::validateCellInBounds(int x, int y) {
+bool Grid::validateCellInBounds(int x, int y) const {
     return x >= 0 && x < width && y >= 0 && y < height;
 }
 
@@ -0,0 +1,224 @@
+#include "headers/ipc/sharedboard.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ipc {
+
+namespace {
+
+constexpr size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+constexpr size_t COMMANDS_OFFSET = alignUp(sizeof(SharedBoardHeader), 64);
+constexpr size_t TILES_OFFSET = alignUp(COMMANDS_OFFSET + sizeof(SharedCommand) * SHARED_COMMAND_CAPACITY, 64);
+
+}  // namespace
+
+SharedBoard::SharedBoard(const std::string& name) : name(name) {
+#ifdef _WIN32
+    throw std::runtime_error("Shared board needs posix shared memory, not available on windows");
+#else
+    if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos)
+        throw std::runtime_error("Shared board name has to look like /name, got " + name);
+#endif
+}
+
+SharedBoard::~SharedBoard() {
+    attach(nullptr);
+}
+
+void SharedBoard::attach(Grid* grid) {
+    if (this->grid) {
+        this->grid->removeListener(this);
+        closeSegment();
+    }
+    this->grid = grid;
+    if (!grid)
+        return;
+
+    openSegment();
+    grid->addListener(this);
+    allDirty = true;
+    publish();
+}
+
+#ifdef _WIN32
+
+void SharedBoard::openSegment() {
+    throw std::runtime_error("Shared board needs posix shared memory, not available on windows");
+}
+
+void SharedBoard::closeSegment() {
+}
+
+#else
+
+void SharedBoard::openSegment() {
+    size_t size = TILES_OFFSET + static_cast<size_t>(grid->width) * grid->height;
+
+    // a reader may still hold the last game's segment, it keeps that one until it sees closed
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+        throw std::runtime_error("Could not create shared board " + name);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Could not size shared board " + name);
+    }
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the segment alive
+    if (view == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Could not map shared board " + name);
+    }
+
+    base = static_cast<uint8_t*>(view);
+    length = size;
+    header = new (base) SharedBoardHeader{};
+    commands = reinterpret_cast<SharedCommand*>(base + COMMANDS_OFFSET);
+    tiles = base + TILES_OFFSET;
+
+    header->width = grid->width;
+    header->height = grid->height;
+    header->commandsOffset = COMMANDS_OFFSET;
+    header->tilesOffset = TILES_OFFSET;
+    header->commandCapacity = SHARED_COMMAND_CAPACITY;
+    header->numMine = grid->numMine;
+    header->version = SHARED_BOARD_VERSION;
+    // magic last, a reader that finds it finds the rest filled in
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHARED_BOARD_MAGIC;
+}
+
+void SharedBoard::closeSegment() {
+    if (!base)
+        return;
+    header->closed.store(1, std::memory_order_release);
+    munmap(base, length);
+    shm_unlink(name.c_str());
+
+    base = nullptr;
+    length = 0;
+    header = nullptr;
+    commands = nullptr;
+    tiles = nullptr;
+    dirty.clear();
+}
+
+#endif
+
+void SharedBoard::update() {
+    if (!grid || !header)
+        return;
+
+    uint32_t tail = header->commandTail.load(std::memory_order_relaxed);
+    uint32_t head = header->commandHead.load(std::memory_order_acquire);
+    // the other process could write anything here, a head running past the ring drops the extra
+    if (head - tail > SHARED_COMMAND_CAPACITY)
+        head = tail + SHARED_COMMAND_CAPACITY;
+
+    for (; tail != head; ++tail) {
+        SharedCommand command = commands[tail % SHARED_COMMAND_CAPACITY];
+        if (grid->gameState != GameState::ONGOING || !grid->validateCellInBounds(command.x, command.y))
+            continue;
+
+        switch (command.kind) {
+            case SHARED_COMMAND_REVEAL:
+                grid->reveal(command.x, command.y);
+                break;
+            case SHARED_COMMAND_FLAG:
+                grid->flag(command.x, command.y);
+                break;
+            case SHARED_COMMAND_CHORD:
+                grid->chord(command.x, command.y);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // published before the tail moves, a reader seeing its move consumed also sees what it did
+    publish();
+    header->commandTail.store(tail, std::memory_order_release);
+}
+
+void SharedBoard::publish() {
+    // the win flips gameState without a notification, so the header is compared too
+    bool headerChanged = header->gameState != static_cast<int32_t>(grid->gameState) ||
+                         header->revealedSafeCells != grid->revealedSafeCells;
+    if (!allDirty && dirty.empty() && !headerChanged)
+        return;
+
+    uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (allDirty) {
+        copyAllTiles();
+    } else {
+        for (int64_t cell : dirty)
+            tiles[cell] = grid->tileAt(static_cast<int>(cell % grid->width), static_cast<int>(cell / grid->width));
+    }
+    header->gameState = static_cast<int32_t>(grid->gameState);
+    header->revealedSafeCells = grid->revealedSafeCells;
+    header->visibleHash = grid->visibleHash;
+
+    header->sequence.store(sequence + 2, std::memory_order_release);
+    dirty.clear();
+    allDirty = false;
+}
+
+// whole chunk rows at a time, untouched chunks are blank without being read
+void SharedBoard::copyAllTiles() {
+    int width = grid->width;
+    for (int y = 0; y < grid->height; ++y) {
+        uint8_t* row = tiles + static_cast<size_t>(y) * width;
+        int chunkY = y / CHUNK_SIZE;
+        int localY = y % CHUNK_SIZE;
+        for (int chunkX = 0; chunkX < grid->chunksWide; ++chunkX) {
+            int firstX = chunkX * CHUNK_SIZE;
+            int columns = std::min(CHUNK_SIZE, width - firstX);
+            const Chunk* chunk = grid->findChunk(chunkX, chunkY);
+            if (chunk) {
+                for (int localX = 0; localX < columns; ++localX)
+                    row[firstX + localX] = chunk->cells[chunkCellIndex(grid->cellLayout, localX, localY)].renderTile;
+            } else if (grid->gameState == GameState::LOST) {
+                // mines in untouched chunks only show through tileAt
+                for (int localX = 0; localX < columns; ++localX)
+                    row[firstX + localX] = grid->tileAt(firstX + localX, y);
+            } else {
+                std::memset(row + firstX, TILE_BLANK, columns);
+            }
+        }
+    }
+}
+
+void SharedBoard::onCellChanged(int x, int y) {
+    // past an eighth of the board one pass over everything is cheaper than the list
+    if (allDirty)
+        return;
+    if (dirty.size() * 8 > static_cast<size_t>(grid->width) * grid->height) {
+        allDirty = true;
+        dirty.clear();
+        return;
+    }
+    dirty.push_back(static_cast<int64_t>(y) * grid->width + x);
+}
+
+void SharedBoard::onBoardChanged() {
+    allDirty = true;
+    dirty.clear();
+}
+
+}  // namespace ipc
@@ -2,7 +2,9 @@
 #include <format>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <random>
+#include <thread>
 
 #include "raylib.h"
 #define RAYGUI_IMPLEMENTATION
@@ -10,8 +12,12 @@
 #include "headers/globals.h"
 #include "headers/grid.h"
 #include "headers/inputcontroller.h"
+#include "headers/ipc/sharedboard.h"
 #include "headers/raygui.h"
 #include "headers/render.h"
+#include "headers/solver/autoplay.h"
+#include "headers/solver/hints.h"
+#include "headers/solver/plugin.h"
 
 using namespace std;
 
@@ -68,6 +74,40 @@ int main() {
     render::LoadAssets();
     static bool debug = false;
 
+    // DANSWEEPER_SHM=/name mirrors each game into shared memory for bots in other processes
+    ipc::SharedBoard* sharedBoard = nullptr;
+    if (const char* sharedName = getenv("DANSWEEPER_SHM")) {
+        try {
+            sharedBoard = new ipc::SharedBoard(sharedName);
+        } catch (const std::exception& e) {
+            cerr << e.what() << endl;
+        }
+    }
+
+    // H toggles hints, a solver on its own thread marks safe cells or the best guess
+    // P toggles a mine probability heatmap worked out by the same solver
+    // the worker starts with the first toggle and idles while both are off
+    solver::HintWorker* hintWorker = nullptr;
+    // big frontier components are sampled on every core but the game's, on machines with a few to spare
+    unsigned cores = std::thread::hardware_concurrency();
+    unsigned samplerThreads = cores > 2 ? cores - 1 : 0;
+    bool showHints = false;
+    bool showHeatmap = false;
+    bool heatmapUploaded = false;
+    uint64_t heatmapHash = 0;
+
+    // A toggles auto play, a solver plays the board on its own thread as fast as it can
+    // DANSWEEPER_PLUGIN=path plays with a solver plugin instead of the built in anytime solver
+    solver::SolverPlugin* autoPlayPlugin = nullptr;
+    if (const char* pluginPath = getenv("DANSWEEPER_PLUGIN")) {
+        try {
+            autoPlayPlugin = new solver::SolverPlugin(pluginPath);
+        } catch (const std::exception& e) {
+            cerr << e.what() << endl;
+        }
+    }
+    solver::AutoPlayer* autoPlayer = nullptr;
+
     // initial manual settings
     static int gridWidth = 9;
     static int gridHeight = 9;
@@ -80,6 +120,10 @@ int main() {
         if (windowState == WindowState::MENU) {
             // if game exists, reset
             if (currentGrid && inputMethodology) {
+                if (sharedBoard)
+                    sharedBoard->attach(nullptr);
+                delete autoPlayer;
+                autoPlayer = nullptr;
                 resetGrid(currentGrid, inputMethodology);
             }
 
@@ -255,14 +299,74 @@ int main() {
                     }
                 }
 
+                if (sharedBoard) {
+                    try {
+                        sharedBoard->attach(currentGrid);
+                    } catch (const std::exception& e) {
+                        cerr << e.what() << endl;
+                        delete sharedBoard;
+                        sharedBoard = nullptr;
+                    }
+                }
                 windowState = WindowState::GAME;
             }
 
         } else if (windowState == WindowState::GAME || windowState == WindowState::PAUSE) {
+            if (windowState == WindowState::GAME && IsKeyPressed(KEY_A)) {
+                if (autoPlayer) {
+                    delete autoPlayer;
+                    autoPlayer = nullptr;
+                } else {
+                    try {
+                        autoPlayer = new solver::AutoPlayer(currentGrid, autoPlayPlugin, std::chrono::milliseconds(5), samplerThreads);
+                    } catch (const std::exception& e) {
+                        cerr << e.what() << endl;
+                    }
+                }
+            }
+
+            // while a bot plays, the frame takes the board between its batches and draws wherever it got to
+            std::unique_lock<std::mutex> gridLock;
+            if (autoPlayer) {
+                autoPlayer->setPaused(windowState == WindowState::PAUSE);
+                gridLock = autoPlayer->lock();
+            }
+
             if (windowState != WindowState::PAUSE) {
                 inputMethodology = new InputController(currentGrid);
+                if (IsKeyPressed(KEY_H))
+                    showHints = !showHints;
+                if (IsKeyPressed(KEY_P))
+                    showHeatmap = !showHeatmap;
+                if ((showHints || showHeatmap) && !hintWorker)
+                    hintWorker = new solver::HintWorker(std::chrono::milliseconds(50), samplerThreads);
+
+                const solver::Hint* hint = nullptr;
+                if (hintWorker && (showHints || showHeatmap)) {
+                    hintWorker->setHeatmap(showHeatmap);
+                    hint = hintWorker->poll(*currentGrid);
+                }
+                if (hint && showHints) {
+                    for (const solver::CellPos& cell : hint->safe)
+                        render::QueueHighlight(cell.x, cell.y);
+                    if (hint->guess.x >= 0)
+                        render::QueueHighlight(hint->guess.x, hint->guess.y);
+                }
+                // uploaded once per hint, between hints the texture is only drawn
+                if (hint && showHeatmap && !hint->heat.empty()) {
+                    if (!heatmapUploaded || heatmapHash != hint->visibleHash) {
+                        render::ShowHeatmap(currentGrid->width, currentGrid->height, hint->heat.data());
+                        heatmapUploaded = true;
+                        heatmapHash = hint->visibleHash;
+                    }
+                } else if (heatmapUploaded) {
+                    render::HideHeatmap();
+                    heatmapUploaded = false;
+                }
                 render::DrawBoard(currentGrid);
                 inputMethodology->handleManualInput();
+                if (sharedBoard)
+                    sharedBoard->update();
             } else {
                 // pause implemented this way to prevent "pause board examination"
                 const int screenWidth = GetScreenWidth();
@@ -316,12 +420,15 @@ int main() {
             DrawTextEx(customFont, std::format("window state: {}", std::string(WindowStateToString(windowState))).c_str(), {10, 25}, 13, 1, WHITE);
 
             if (currentGrid) {
+                std::unique_lock<std::mutex> gridLock;
+                if (autoPlayer)
+                    gridLock = autoPlayer->lock();
                 DrawTextEx(customFont, "grid: exists", {10, 40}, 13, 1, WHITE);
                 if (inputMethodology) {
                     GridCoordinates coords = inputMethodology->handleHoverCursor(render::GetCamera());
                     DrawTextEx(customFont, std::format("(x, y): {}, {}", coords.x, coords.y).c_str(), {10, 55}, 13, 1, WHITE);
                     if (!(coords.x < 0 || coords.x >= currentGrid->width || coords.y < 0 || coords.y >= currentGrid->height)) {
-                        Cell& cellPropertyState = currentGrid->cells[coords.y][coords.x];
+                        const Cell* cellPropertyState = currentGrid->findCell(coords.x, coords.y);
                     }
                 }
                 DrawTextEx(customFont, std::format("seed: {}", currentGrid->seed32).c_str(), {10, 70}, 13, 1, WHITE);
@@ -330,11 +437,17 @@ int main() {
                 DrawTextEx(customFont, std::format("mine: {}", currentGrid->numMine).c_str(), {10, 115}, 13, 1, WHITE);
                 DrawTextEx(customFont, std::format("safe: {}, {}", currentGrid->safeX, currentGrid->safeY).c_str(), {10, 130}, 13, 1, WHITE);
                 DrawTextEx(customFont, std::format("time: {}", currentGrid->timeElapsed).c_str(), {10, 145}, 13, 1, WHITE);
+                if (autoPlayer)
+                    DrawTextEx(customFont, std::format("auto: {} moves, {} guesses", autoPlayer->movesPlayed(), autoPlayer->guessesPlayed()).c_str(), {10, 160}, 13, 1, WHITE);
             }
         }
         EndDrawing();
     }
 
+    delete autoPlayer;
+    delete autoPlayPlugin;
+    delete hintWorker;
+    delete sharedBoard;
     render::UnloadAssets();
     CloseWindow();
     return 0;
@@ -0,0 +1,156 @@
+#include "headers/ml/encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ml {
+
+namespace {
+
+constexpr std::array<uint8_t, 16> makeTileChannels() {
+    std::array<uint8_t, 16> channels{};
+    for (int tile = TILE_1; tile <= TILE_8; ++tile)
+        channels[tile] = static_cast<uint8_t>(CHANNEL_NUMBER_0 + 1 + tile - TILE_1);
+    channels[TILE_REVEALED] = CHANNEL_NUMBER_0;
+    channels[TILE_BLANK] = CHANNEL_UNKNOWN;
+    channels[TILE_QUESTION] = CHANNEL_UNKNOWN;
+    channels[TILE_QUESTION_REVEALED] = CHANNEL_UNKNOWN;
+    channels[TILE_FLAG] = CHANNEL_FLAG;
+    channels[TILE_MINE_WRONG] = CHANNEL_FLAG;
+    channels[TILE_MINE_REVEALED] = CHANNEL_FLAG;
+    channels[TILE_MINE_HIT] = CHANNEL_FLAG;
+    return channels;
+}
+constexpr auto TILE_CHANNELS = makeTileChannels();
+
+// one hot row per channel, nhwc copies a whole cell's channels at once
+template <typename T>
+constexpr std::array<std::array<T, OBSERVATION_CHANNELS>, OBSERVATION_CHANNELS> makeOneHot() {
+    std::array<std::array<T, OBSERVATION_CHANNELS>, OBSERVATION_CHANNELS> rows{};
+    for (int channel = 0; channel < OBSERVATION_CHANNELS; ++channel)
+        rows[channel][channel] = T(1);
+    return rows;
+}
+template <typename T>
+constexpr auto ONE_HOT = makeOneHot<T>();
+
+// channel of every cell in row y, untouched chunks are all unknown until a loss shows their mines
+void readRow(const Grid& grid, int y, uint8_t* channels) {
+    int width = grid.width;
+    int chunkY = y / CHUNK_SIZE;
+    int localY = y % CHUNK_SIZE;
+    bool rowMajor = grid.cellLayout == CellLayout::ROW_MAJOR;
+
+    for (int chunkX = 0; chunkX < grid.chunksWide; ++chunkX) {
+        int firstX = chunkX * CHUNK_SIZE;
+        int columns = std::min(CHUNK_SIZE, width - firstX);
+        const Chunk* chunk = grid.findChunk(chunkX, chunkY);
+        if (!chunk) {
+            if (grid.gameState == GameState::LOST) {
+                // mines in untouched chunks only show through tileAt
+                for (int localX = 0; localX < columns; ++localX)
+                    channels[firstX + localX] = TILE_CHANNELS[grid.tileAt(firstX + localX, y) & 15];
+            } else {
+                std::memset(channels + firstX, CHANNEL_UNKNOWN, columns);
+            }
+            continue;
+        }
+
+        if (rowMajor) {
+            const Cell* cells = &chunk->cells[localY * CHUNK_SIZE];
+            for (int localX = 0; localX < columns; ++localX)
+                channels[firstX + localX] = TILE_CHANNELS[cells[localX].renderTile & 15];
+        } else {
+            for (int localX = 0; localX < columns; ++localX)
+                channels[firstX + localX] =
+                    TILE_CHANNELS[chunk->cells[chunkCellIndex(CellLayout::MORTON, localX, localY)].renderTile & 15];
+        }
+    }
+}
+
+// nchw, one channel plane, 16 cells per compare
+void writePlane(const uint8_t* channels, size_t size, uint8_t channel, uint8_t* output) {
+    size_t x = 0;
+#if defined(__SSE2__)
+    const __m128i wanted = _mm_set1_epi8(static_cast<char>(channel));
+    const __m128i one = _mm_set1_epi8(1);
+    for (; x + 16 <= size; x += 16) {
+        __m128i hit = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(channels + x)), wanted);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), _mm_and_si128(hit, one));
+    }
+#endif
+    for (; x < size; ++x)
+        output[x] = channels[x] == channel;
+}
+
+void writePlane(const uint8_t* channels, size_t size, uint8_t channel, float* output) {
+    size_t x = 0;
+#if defined(__SSE2__)
+    // byte masks widened to 32 bits, all ones and 1.0f is 1.0f
+    const __m128i wanted = _mm_set1_epi8(static_cast<char>(channel));
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; x + 16 <= size; x += 16) {
+        __m128i hit = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(channels + x)), wanted);
+        __m128i low = _mm_unpacklo_epi8(hit, hit);
+        __m128i high = _mm_unpackhi_epi8(hit, hit);
+        _mm_storeu_ps(output + x, _mm_and_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(low, low)), one));
+        _mm_storeu_ps(output + x + 4, _mm_and_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(low, low)), one));
+        _mm_storeu_ps(output + x + 8, _mm_and_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(high, high)), one));
+        _mm_storeu_ps(output + x + 12, _mm_and_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(high, high)), one));
+    }
+#endif
+    for (; x < size; ++x)
+        output[x] = channels[x] == channel ? 1.0f : 0.0f;
+}
+
+template <typename T>
+void encode(const Grid* const* grids, size_t count, TensorLayout layout, T* output) {
+    if (count == 0)
+        return;
+    int width = grids[0]->width;
+    int height = grids[0]->height;
+    for (size_t i = 1; i < count; ++i)
+        if (grids[i]->width != width || grids[i]->height != height)
+            throw std::runtime_error("encodeBoards needs boards of one size");
+
+    // a channel's plane is contiguous in nchw, so the whole board is read first and each channel is one long run
+    size_t plane = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> channels(plane);
+    for (size_t i = 0; i < count; ++i) {
+        for (int y = 0; y < height; ++y)
+            readRow(*grids[i], y, channels.data() + static_cast<size_t>(y) * width);
+
+        T* board = output + i * plane * OBSERVATION_CHANNELS;
+        if (layout == TensorLayout::NCHW) {
+            for (int channel = 0; channel < OBSERVATION_CHANNELS; ++channel)
+                writePlane(channels.data(), plane, static_cast<uint8_t>(channel), board + channel * plane);
+        } else {
+            T* cell = board;
+            for (size_t c = 0; c < plane; ++c, cell += OBSERVATION_CHANNELS)
+                std::memcpy(cell, ONE_HOT<T>[channels[c]].data(), sizeof(T) * OBSERVATION_CHANNELS);
+        }
+    }
+}
+
+}  // namespace
+
+size_t observationSize(const Grid& grid) {
+    return static_cast<size_t>(grid.width) * grid.height * OBSERVATION_CHANNELS;
+}
+
+void encodeBoards(const Grid* const* grids, size_t count, TensorLayout layout, float* output) {
+    encode(grids, count, layout, output);
+}
+
+void encodeBoards(const Grid* const* grids, size_t count, TensorLayout layout, uint8_t* output) {
+    encode(grids, count, layout, output);
+}
+
+}  // namespace ml
@@ -0,0 +1,231 @@
+#include "headers/ml/vecenv.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "headers/utils/gridutils.h"
+
+// structure of arrays, per cell arrays hold every board back to back, per board arrays one entry each
+struct dansweeper_vecenv {
+    int32_t boards = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t cells = 0;
+    int64_t totalMines = 0;
+    dansweeper_vecenv_config config{};
+
+    // per cell
+    std::vector<uint8_t> mine;      // 1 for a mine, valid once the board is generated
+    std::vector<uint8_t> adjacent;  // mines around, 0..8
+    std::vector<uint8_t> visible;   // exactly the observation, a number or DANSWEEPER_HIDDEN
+
+    // per board
+    std::vector<uint8_t> generated;      // mines are placed on the first reveal so it is always safe
+    std::vector<int32_t> safeLeft;       // safe cells still hidden
+    std::vector<int32_t> steps;          // steps into the episode
+    std::vector<uint32_t> episodeSeeds;  // prng seed of the current episode
+
+    std::mt19937_64 seeder;
+    std::vector<int32_t> pending;  // flood fill stack, one board at a time so one is enough
+};
+
+namespace {
+
+void resetBoard(dansweeper_vecenv& env, int32_t board) {
+    size_t first = static_cast<size_t>(board) * env.cells;
+    std::fill_n(env.visible.begin() + first, env.cells, DANSWEEPER_HIDDEN);
+    env.generated[board] = 0;
+    env.safeLeft[board] = static_cast<int32_t>(env.cells - env.totalMines);
+    env.steps[board] = 0;
+    env.episodeSeeds[board] = static_cast<uint32_t>(env.seeder());
+}
+
+// same placement as Grid::initMinePermutation and Grid::isMine, every cell in row order with the safe cell skipped,
+// the seed goes through the int the game keeps it in
+void generateBoard(dansweeper_vecenv& env, int32_t board, int32_t safeCell) {
+    uint64_t seed = static_cast<uint64_t>(static_cast<int>(env.episodeSeeds[board]));
+    gridutils::IndexPermutation permutation = gridutils::makeIndexPermutation(static_cast<uint64_t>(env.cells) - 1, seed);
+
+    uint8_t* mine = env.mine.data() + static_cast<size_t>(board) * env.cells;
+    uint8_t* adjacent = env.adjacent.data() + static_cast<size_t>(board) * env.cells;
+    // a cell is a mine when its index permutes under totalMines, so the mines are exactly those values unpermuted
+    std::fill_n(mine, env.cells, 0);
+    for (int64_t rank = 0; rank < env.totalMines; ++rank) {
+        int64_t index = static_cast<int64_t>(gridutils::unpermuteIndex(permutation, static_cast<uint64_t>(rank)));
+        mine[index >= safeCell ? index + 1 : index] = 1;
+    }
+
+    for (int32_t y = 0; y < env.height; ++y) {
+        for (int32_t x = 0; x < env.width; ++x) {
+            int count = 0;
+            for (int32_t ny = std::max(0, y - 1); ny <= std::min(env.height - 1, y + 1); ++ny)
+                for (int32_t nx = std::max(0, x - 1); nx <= std::min(env.width - 1, x + 1); ++nx)
+                    count += mine[ny * env.width + nx];
+            adjacent[y * env.width + x] = static_cast<uint8_t>(count - mine[y * env.width + x]);
+        }
+    }
+    env.generated[board] = 1;
+}
+
+// reveals like Grid::reveal, zeros open their neighbours, returns cells revealed
+int32_t reveal(dansweeper_vecenv& env, int32_t board, int32_t start) {
+    const uint8_t* adjacent = env.adjacent.data() + static_cast<size_t>(board) * env.cells;
+    uint8_t* visible = env.visible.data() + static_cast<size_t>(board) * env.cells;
+
+    int32_t revealed = 0;
+    env.pending.clear();  // keeps its capacity, reserved for a whole board in create
+    env.pending.push_back(start);
+    visible[start] = adjacent[start];
+    while (!env.pending.empty()) {
+        int32_t cell = env.pending.back();
+        env.pending.pop_back();
+        revealed++;
+        if (adjacent[cell] != 0)
+            continue;
+
+        int32_t x = cell % env.width;
+        int32_t y = cell / env.width;
+        for (int32_t ny = std::max(0, y - 1); ny <= std::min(env.height - 1, y + 1); ++ny) {
+            for (int32_t nx = std::max(0, x - 1); nx <= std::min(env.width - 1, x + 1); ++nx) {
+                int32_t next = ny * env.width + nx;
+                if (visible[next] != DANSWEEPER_HIDDEN)
+                    continue;
+                visible[next] = adjacent[next];
+                env.pending.push_back(next);
+            }
+        }
+    }
+    return revealed;
+}
+
+}  // namespace
+
+extern "C" {
+
+dansweeper_vecenv_config dansweeper_vecenv_default_config(int32_t width, int32_t height, int32_t mines) {
+    dansweeper_vecenv_config config{};
+    config.width = width;
+    config.height = height;
+    config.mines = mines;
+    config.max_steps = 0;
+    config.reward_win = 1.0f;
+    config.reward_loss = -1.0f;
+    config.reward_reveal = 0.1f;
+    config.reward_repeat = -0.1f;
+    return config;
+}
+
+dansweeper_vecenv* dansweeper_vecenv_create(int32_t boards, const dansweeper_vecenv_config* config, uint64_t seed) {
+    if (!config || boards <= 0 || config->width <= 0 || config->height <= 0 || config->mines < 0 ||
+        config->max_steps < 0)
+        return nullptr;
+    int64_t cells = static_cast<int64_t>(config->width) * config->height;
+    if (config->mines >= cells || cells > INT32_MAX || cells * boards > INT32_MAX)
+        return nullptr;
+
+    // the abi can't carry exceptions, running out of memory is just a null env
+    try {
+        auto env = std::make_unique<dansweeper_vecenv>();
+        env->boards = boards;
+        env->width = config->width;
+        env->height = config->height;
+        env->cells = static_cast<int32_t>(cells);
+        env->totalMines = config->mines;
+        env->config = *config;
+
+        size_t total = static_cast<size_t>(cells) * boards;
+        env->mine.assign(total, 0);
+        env->adjacent.assign(total, 0);
+        env->visible.assign(total, DANSWEEPER_HIDDEN);
+        env->generated.assign(boards, 0);
+        env->safeLeft.assign(boards, 0);
+        env->steps.assign(boards, 0);
+        env->episodeSeeds.assign(boards, 0);
+        env->seeder.seed(seed);
+        env->pending.reserve(static_cast<size_t>(cells));
+
+        for (int32_t board = 0; board < boards; ++board)
+            resetBoard(*env, board);
+        return env.release();
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void dansweeper_vecenv_destroy(dansweeper_vecenv* env) {
+    delete env;
+}
+
+int32_t dansweeper_vecenv_boards(const dansweeper_vecenv* env) {
+    return env ? env->boards : 0;
+}
+
+int32_t dansweeper_vecenv_cells(const dansweeper_vecenv* env) {
+    return env ? env->cells : 0;
+}
+
+int32_t dansweeper_vecenv_reset_batch(dansweeper_vecenv* env, uint8_t* observations) {
+    if (!env || !observations)
+        return DANSWEEPER_INVALID_ARGUMENT;
+
+    for (int32_t board = 0; board < env->boards; ++board)
+        resetBoard(*env, board);
+    std::memcpy(observations, env->visible.data(), env->visible.size());
+    return DANSWEEPER_OK;
+}
+
+int32_t dansweeper_vecenv_step_batch(dansweeper_vecenv* env, const int32_t* actions, uint8_t* observations,
+                                     float* rewards, uint8_t* dones) {
+    if (!env || !actions || !observations || !rewards || !dones)
+        return DANSWEEPER_INVALID_ARGUMENT;
+    for (int32_t board = 0; board < env->boards; ++board)
+        if (actions[board] < 0 || actions[board] >= env->cells)
+            return DANSWEEPER_INVALID_ARGUMENT;
+
+    const dansweeper_vecenv_config& config = env->config;
+    for (int32_t board = 0; board < env->boards; ++board) {
+        int32_t cell = actions[board];
+        size_t index = static_cast<size_t>(board) * env->cells + cell;
+        bool done = false;
+        float reward;
+
+        if (!env->generated[board])
+            generateBoard(*env, board, cell);
+
+        if (env->visible[index] != DANSWEEPER_HIDDEN) {
+            reward = config.reward_repeat;
+        } else if (env->mine[index]) {
+            reward = config.reward_loss;
+            done = true;
+        } else {
+            env->safeLeft[board] -= reveal(*env, board, cell);
+            done = env->safeLeft[board] == 0;
+            reward = done ? config.reward_win : config.reward_reveal;
+        }
+
+        env->steps[board]++;
+        if (config.max_steps > 0 && env->steps[board] >= config.max_steps)
+            done = true;
+
+        rewards[board] = reward;
+        dones[board] = done ? 1 : 0;
+        if (done)
+            resetBoard(*env, board);
+    }
+
+    std::memcpy(observations, env->visible.data(), env->visible.size());
+    return DANSWEEPER_OK;
+}
+
+uint32_t dansweeper_vecenv_episode_seed(const dansweeper_vecenv* env, int32_t board) {
+    if (!env || board < 0 || board >= env->boards)
+        return 0;
+    return env->episodeSeeds[board];
+}
+
+}  // extern "C"
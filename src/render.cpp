@@ -1,7 +1,10 @@
 #include "headers/render.h"
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <mutex>
 #include <vector>
 
 #include "headers/globals.h"
@@ -18,25 +21,128 @@ static Camera2D camera;
 static const Grid* activeGrid = nullptr;
 
 // highlight tile
-static std::vector<std::pair<int, int>> highlightedTiles;
-static std::mutex highlightMutex;
+// bounded multi producer single consumer ring, solver threads push without ever waiting on the render loop
+// a slot's sequence says whose turn it is, equal to a push position the slot is free for it,
+// one past it the slot holds that push's tile and the render loop may take it
+static constexpr size_t HIGHLIGHT_CAPACITY = 1 << 16;
+static constexpr size_t HIGHLIGHT_MASK = HIGHLIGHT_CAPACITY - 1;
+
+struct HighlightSlot {
+    std::atomic<size_t> sequence;
+    int x;
+    int y;
+};
+
+struct HighlightRing {
+    HighlightRing() {
+        for (size_t i = 0; i < HIGHLIGHT_CAPACITY; ++i)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    alignas(64) std::atomic<size_t> head{0};  // next push position, shared by producers
+    alignas(64) size_t tail = 0;              // next pop position, render loop only
+    std::array<HighlightSlot, HIGHLIGHT_CAPACITY> slots;
+};
+static HighlightRing highlights;
+
+// heatmap
+// texels are cells, 0 is nothing to show and 1..255 maps onto a green to red ramp at a fixed alpha
+static const char* HEATMAP_FRAGMENT_SHADER = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+
+void main() {
+    float value = texture(texture0, fragTexCoord).r * 255.0;
+    if (value < 0.5)
+        discard;
+    float probability = (value - 1.0) / 254.0;
+    vec3 color = probability < 0.5 ? mix(vec3(0.1, 0.8, 0.2), vec3(0.95, 0.85, 0.1), probability * 2.0)
+                                   : mix(vec3(0.95, 0.85, 0.1), vec3(0.9, 0.1, 0.1), probability * 2.0 - 1.0);
+    finalColor = vec4(color, 0.45) * colDiffuse;
+}
+)";
+static const int HEATMAP_MAX_SIDE = 16384;  // what desktop gpus take for a texture side
+static Shader heatmapShader;
+static Texture2D heatmapTexture = {0};
+static bool heatmapVisible = false;
 
 bool showEndscreen = false;
 GameState previousWindowState = GameState::ONGOING;
 
-void QueueHighlight(int x, int y) {
-    std::lock_guard<std::mutex> lock(highlightMutex);
-    highlightedTiles.push_back({x, y});
+bool QueueHighlight(int x, int y) {
+    size_t position = highlights.head.load(std::memory_order_relaxed);
+    HighlightSlot* slot;
+    while (true) {
+        slot = &highlights.slots[position & HIGHLIGHT_MASK];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (lag == 0) {
+            // claim the position, on failure position is reloaded and the next slot tried
+            if (highlights.head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (lag < 0) {
+            return false;  // a lap behind, the render loop hasn't drained this slot yet
+        } else {
+            position = highlights.head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->x = x;
+    slot->y = y;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
 }
 
 void LoadAssets() {
     Image texturemap = LoadImage("resources/texturemap.png");
     textureTileset = LoadTextureFromImage(texturemap);
     UnloadImage(texturemap);
+    heatmapShader = LoadShaderFromMemory(nullptr, HEATMAP_FRAGMENT_SHADER);
 }
 
 void UnloadAssets() {
     UnloadTexture(textureTileset);
+    if (heatmapTexture.id != 0)
+        UnloadTexture(heatmapTexture);
+    heatmapTexture = {0};
+    heatmapVisible = false;
+    UnloadShader(heatmapShader);
+}
+
+bool ShowHeatmap(int width, int height, const unsigned char* heat) {
+    if (width > HEATMAP_MAX_SIDE || height > HEATMAP_MAX_SIDE) {
+        heatmapVisible = false;
+        return false;
+    }
+
+    // same size boards reuse the texture, a new board reallocates it once
+    if (heatmapTexture.id == 0 || heatmapTexture.width != width || heatmapTexture.height != height) {
+        if (heatmapTexture.id != 0)
+            UnloadTexture(heatmapTexture);
+        Image image = {const_cast<unsigned char*>(heat), width, height, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE};
+        heatmapTexture = LoadTextureFromImage(image);
+        SetTextureFilter(heatmapTexture, TEXTURE_FILTER_POINT);
+    } else {
+        UpdateTexture(heatmapTexture, heat);
+    }
+    heatmapVisible = true;
+    return true;
+}
+
+void HideHeatmap() {
+    heatmapVisible = false;
+}
+
+static void drawHeatmap(const Grid* grid) {
+    if (!heatmapVisible || heatmapTexture.width != grid->width || heatmapTexture.height != grid->height)
+        return;
+    Rectangle source = {0, 0, (float)grid->width, (float)grid->height};
+    Rectangle dest = {0, 0, (float)(grid->width * TILE_TEXTURE_PIXEL_SIZE), (float)(grid->height * TILE_TEXTURE_PIXEL_SIZE)};
+    BeginShaderMode(heatmapShader);
+    DrawTexturePro(heatmapTexture, source, dest, {0, 0}, 0.0f, WHITE);
+    EndShaderMode();
 }
 
 void CenterCameraOnMap(const Grid* grid) {
@@ -70,7 +176,8 @@ void DrawBoard(const Grid* grid) {
 
     for (int y = startY; y < endY; y++) {
         for (int x = startX; x < endX; x++) {
-            int tileID = grid->cells[y][x].renderTile;
+            // untouched chunks read as blank without being created
+            int tileID = grid->tileAt(x, y);
             int srcX = (tileID % TILESET_COLS) * TILE_TEXTURE_PIXEL_SIZE;
             int srcY = (tileID / TILESET_COLS) * TILE_TEXTURE_PIXEL_SIZE;
 
@@ -80,6 +187,7 @@ void DrawBoard(const Grid* grid) {
         }
     };
 
+    drawHeatmap(grid);
     render::highlightTile();
 
     EndMode2D();
@@ -130,17 +238,23 @@ void DrawBoard(const Grid* grid) {
 }
 
 void highlightTile() {
-    std::lock_guard<std::mutex> lock(highlightMutex);
-    for (std::pair<int, int> tilePos : highlightedTiles) {
+    // at most one ring's worth per frame, so producers that never stop can't keep the frame from ending
+    for (size_t drawn = 0; drawn < HIGHLIGHT_CAPACITY; ++drawn) {
+        HighlightSlot& slot = highlights.slots[highlights.tail & HIGHLIGHT_MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != highlights.tail + 1)
+            break;  // empty, or a producer claimed the slot and is still writing it
         Rectangle tile = {
-            tilePos.first * TILE_TEXTURE_PIXEL_SIZE,
-            tilePos.second * TILE_TEXTURE_PIXEL_SIZE,
+            slot.x * TILE_TEXTURE_PIXEL_SIZE,
+            slot.y * TILE_TEXTURE_PIXEL_SIZE,
             TILE_TEXTURE_PIXEL_SIZE,
             TILE_TEXTURE_PIXEL_SIZE};
+        // hand the slot back for the push one lap later
+        slot.sequence.store(highlights.tail + HIGHLIGHT_CAPACITY, std::memory_order_release);
+        highlights.tail++;
+
         DrawRectangleRec(tile, Fade(YELLOW, 0.3f));
         DrawRectangleLinesEx(tile, 1, RED);
     }
-    highlightedTiles.clear();  // Draw once per frame
 }
 
 Camera2D& GetCamera() {
@@ -0,0 +1,33 @@
+#include "headers/solver/anytime.h"
+
+#include <algorithm>
+
+namespace solver {
+
+AnytimeSolver::AnytimeSolver(Grid* grid, MonteCarloEstimator* sampler) : rules(grid), endgame(grid), probabilities(grid) {
+    probabilities.sampler = sampler;
+}
+
+ProbabilityMap AnytimeSolver::solve(std::chrono::microseconds budget) {
+    auto start = std::chrono::steady_clock::now();
+
+    ProbabilityMap result;
+    // a huge opening leaves the rules seconds of work, whatever they found by the deadline is the answer
+    result.certain = rules.solve(start + budget);
+    if (!result.certain.empty() || rules.pending()) {
+        lastStage = AnytimeStage::RULES;
+        return result;
+    }
+
+    if (endgame.solve(result)) {
+        lastStage = AnytimeStage::ENDGAME;
+        return result;
+    }
+
+    auto spent = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    result = probabilities.solveWithin(std::max(budget - spent, std::chrono::microseconds::zero()));
+    lastStage = result.exact ? AnytimeStage::EXACT : AnytimeStage::SAMPLED;
+    return result;
+}
+
+}  // namespace solver
@@ -0,0 +1,115 @@
+#include "headers/solver/autoplay.h"
+
+namespace solver {
+
+AutoPlayer::AutoPlayer(Grid* grid, const SolverPlugin* plugin, std::chrono::microseconds budget,
+                       unsigned samplerThreads)
+    : grid(grid), budget(budget) {
+    // built here, on the thread that owns the grid until the worker starts
+    if (plugin) {
+        pluginSolver = std::make_unique<PluginSolver>(*plugin, grid, static_cast<uint64_t>(grid->prngSeed));
+    } else {
+        if (samplerThreads > 0)
+            sampler = std::make_unique<MonteCarloEstimator>(samplerThreads);
+        anytime = std::make_unique<AnytimeSolver>(grid, sampler.get());
+    }
+    thread = std::thread(&AutoPlayer::run, this);
+}
+
+AutoPlayer::~AutoPlayer() {
+    stopping.store(true, std::memory_order_relaxed);
+    thread.join();
+}
+
+std::unique_lock<std::mutex> AutoPlayer::lock() {
+    waiting.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> guard(mutex);
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+    return guard;
+}
+
+void AutoPlayer::run() {
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (paused.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        // a waiting frame goes first, the mutex alone would usually hand the lock straight back to this thread
+        if (waiting.load(std::memory_order_relaxed) > 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!step())
+            break;
+    }
+    done.store(true, std::memory_order_release);
+}
+
+// one batch, false once there is nothing left to play
+bool AutoPlayer::step() {
+    if (grid->gameState != GameState::ONGOING)
+        return false;
+
+    if (grid->firstClick) {
+        // seeded boards know their safe cell, otherwise the first reveal is always safe
+        int x = grid->safeX >= 0 ? grid->safeX : grid->width / 2;
+        int y = grid->safeY >= 0 ? grid->safeY : grid->height / 2;
+        grid->reveal(x, y);
+        moves.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (queued.empty()) {
+        // every move of the last solve changed nothing, asking again would get the same answer forever
+        if (solvedOnce && grid->visibleHash == solvedHash)
+            return false;
+
+        ProbabilityMap move;
+        if (pluginSolver) {
+            move = pluginSolver->solve(budget);
+        } else {
+            move = anytime->solve(budget);
+            if (move.certain.empty() && anytime->pending())
+                return true;
+        }
+        solvedOnce = true;
+        solvedHash = grid->visibleHash;
+        for (const CellPos& mine : move.certain.mines)
+            queued.push_back({mine, true});
+        for (const CellPos& safe : move.certain.safe)
+            queued.push_back({safe, false});
+
+        if (queued.empty()) {
+            if (move.bestGuess.x < 0)
+                return false;
+            grid->reveal(move.bestGuess.x, move.bestGuess.y);
+            guesses.fetch_add(1, std::memory_order_relaxed);
+            moves.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        // the solve may have used up the batch, a waiting frame gets the board before any of its moves
+        if (waiting.load(std::memory_order_relaxed) > 0)
+            return true;
+    }
+
+    // rules can hand back thousands of cells at once, playing them in one go would hold a frame for tens of ms
+    uint64_t played = 0;
+    while (!queued.empty() && grid->gameState == GameState::ONGOING && waiting.load(std::memory_order_relaxed) == 0) {
+        QueuedMove move = queued.front();
+        queued.pop_front();
+        Cell cell = grid->getCellProperties(move.cell.x, move.cell.y);
+        if (move.mine && !cell.flagged) {
+            grid->flag(move.cell.x, move.cell.y);
+            played++;
+        } else if (!move.mine && !cell.revealed) {
+            grid->reveal(move.cell.x, move.cell.y);
+            played++;
+        }
+    }
+    moves.fetch_add(played, std::memory_order_relaxed);
+    return true;
+}
+
+}  // namespace solver
@@ -0,0 +1,348 @@
+#include "headers/solver/bitboard.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "headers/solver/view.h"
+
+namespace solver {
+
+namespace {
+
+// a lane is as many plane words as one simd register holds, a plain word without simd
+// neighbours left and right come from loads one word off, so every load is unaligned
+#if defined(__AVX2__)
+constexpr int LANE_WORDS = 4;
+struct Lane {
+    __m256i v;
+};
+inline Lane loadLane(const uint64_t* p) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))}; }
+inline void storeLane(uint64_t* p, Lane a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a.v); }
+inline Lane operator&(Lane a, Lane b) { return {_mm256_and_si256(a.v, b.v)}; }
+inline Lane operator|(Lane a, Lane b) { return {_mm256_or_si256(a.v, b.v)}; }
+inline Lane operator^(Lane a, Lane b) { return {_mm256_xor_si256(a.v, b.v)}; }
+inline Lane andNot(Lane a, Lane b) { return {_mm256_andnot_si256(b.v, a.v)}; }
+inline Lane zeroLane() { return {_mm256_setzero_si256()}; }
+inline Lane onesLane() { return {_mm256_set1_epi64x(-1)}; }
+inline bool anySet(Lane a) { return !_mm256_testz_si256(a.v, a.v); }
+template <int N>
+inline Lane shiftUp(Lane a) { return {_mm256_slli_epi64(a.v, N)}; }
+template <int N>
+inline Lane shiftDown(Lane a) { return {_mm256_srli_epi64(a.v, N)}; }
+#elif defined(__SSE2__)
+constexpr int LANE_WORDS = 2;
+struct Lane {
+    __m128i v;
+};
+inline Lane loadLane(const uint64_t* p) { return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))}; }
+inline void storeLane(uint64_t* p, Lane a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a.v); }
+inline Lane operator&(Lane a, Lane b) { return {_mm_and_si128(a.v, b.v)}; }
+inline Lane operator|(Lane a, Lane b) { return {_mm_or_si128(a.v, b.v)}; }
+inline Lane operator^(Lane a, Lane b) { return {_mm_xor_si128(a.v, b.v)}; }
+inline Lane andNot(Lane a, Lane b) { return {_mm_andnot_si128(b.v, a.v)}; }
+inline Lane zeroLane() { return {_mm_setzero_si128()}; }
+inline Lane onesLane() { return {_mm_set1_epi32(-1)}; }
+inline bool anySet(Lane a) { return _mm_movemask_epi8(_mm_cmpeq_epi8(a.v, _mm_setzero_si128())) != 0xffff; }
+template <int N>
+inline Lane shiftUp(Lane a) { return {_mm_slli_epi64(a.v, N)}; }
+template <int N>
+inline Lane shiftDown(Lane a) { return {_mm_srli_epi64(a.v, N)}; }
+#else
+constexpr int LANE_WORDS = 1;
+struct Lane {
+    uint64_t v;
+};
+inline Lane loadLane(const uint64_t* p) { return {*p}; }
+inline void storeLane(uint64_t* p, Lane a) { *p = a.v; }
+inline Lane operator&(Lane a, Lane b) { return {a.v & b.v}; }
+inline Lane operator|(Lane a, Lane b) { return {a.v | b.v}; }
+inline Lane operator^(Lane a, Lane b) { return {a.v ^ b.v}; }
+inline Lane andNot(Lane a, Lane b) { return {a.v & ~b.v}; }
+inline Lane zeroLane() { return {0}; }
+inline Lane onesLane() { return {~uint64_t(0)}; }
+inline bool anySet(Lane a) { return a.v != 0; }
+template <int N>
+inline Lane shiftUp(Lane a) { return {a.v << N}; }
+template <int N>
+inline Lane shiftDown(Lane a) { return {a.v >> N}; }
+#endif
+
+// bit x of a word is cell x, so the cell to the left of x sits one bit lower and may be in the word before
+inline Lane fromLeft(const uint64_t* p) { return shiftUp<1>(loadLane(p)) | shiftDown<63>(loadLane(p - 1)); }
+inline Lane fromRight(const uint64_t* p) { return shiftDown<1>(loadLane(p)) | shiftUp<63>(loadLane(p + 1)); }
+
+inline void fullAdd(Lane a, Lane b, Lane c, Lane& sum, Lane& carry) {
+    Lane half = a ^ b;
+    sum = half ^ c;
+    carry = (a & b) | (half & c);
+}
+
+// the 8 neighbours of every cell in a lane of row middle added into 4 bit sliced planes, 0..8
+struct Count {
+    Lane bit[4];
+};
+
+inline Count countNeighbors(const uint64_t* above, const uint64_t* middle, const uint64_t* below) {
+    Lane s0, c0, s1, c1, s2, c2;
+    fullAdd(fromLeft(above), loadLane(above), fromRight(above), s0, c0);
+    fullAdd(fromLeft(middle), fromRight(middle), fromLeft(below), s1, c1);
+    fullAdd(s0, s1, loadLane(below), s2, c2);
+    Lane last = fromRight(below);
+
+    Count count;
+    count.bit[0] = s2 ^ last;
+    Lane twos, fours;
+    fullAdd(c0, c1, c2, twos, fours);
+    Lane carry = s2 & last;
+    count.bit[1] = twos ^ carry;
+    Lane moreFours = twos & carry;
+    count.bit[2] = fours ^ moreFours;
+    count.bit[3] = fours & moreFours;
+    return count;
+}
+
+inline Count add(const Count& a, const Count& b) {
+    Count sum;
+    Lane carry = zeroLane();
+    for (int p = 0; p < 4; ++p)
+        fullAdd(a.bit[p], b.bit[p], carry, sum.bit[p], carry);
+    return sum;
+}
+
+// set where the two counts are equal
+inline Lane equal(const Count& a, const Count& b) {
+    Lane differ = (a.bit[0] ^ b.bit[0]) | (a.bit[1] ^ b.bit[1]) | (a.bit[2] ^ b.bit[2]) | (a.bit[3] ^ b.bit[3]);
+    return differ ^ onesLane();
+}
+
+// every cell next to a set cell of rows above, middle or below, the cells themselves included
+inline Lane spread(const uint64_t* above, const uint64_t* middle, const uint64_t* below) {
+    Lane center = loadLane(above) | loadLane(middle) | loadLane(below);
+    Lane left = loadLane(above - 1) | loadLane(middle - 1) | loadLane(below - 1);
+    Lane right = loadLane(above + 1) | loadLane(middle + 1) | loadLane(below + 1);
+    return center | shiftUp<1>(center) | shiftDown<63>(left) | shiftDown<1>(center) | shiftUp<63>(right);
+}
+
+}  // namespace
+
+BitboardSolver::BitboardSolver(Grid* grid) : grid(grid) {}
+
+Deductions BitboardSolver::solve() {
+    load();
+    iterations = 0;
+    rowsCounted = 0;
+
+    std::vector<int> counting(height);
+    for (int y = 0; y < height; ++y)
+        counting[y] = y;
+    std::vector<int> marked;
+    std::vector<int> applying;
+    std::vector<int> changed;
+
+    // jacobi style, every number of a pass sees the board as the last pass left it
+    // a change can only matter to numbers next to it, so the next pass checks just those
+    while (!counting.empty()) {
+        iterations++;
+        rowsCounted += counting.size();
+        marked.clear();
+        for (int y : counting)
+            if (countRow(y, iterations == 1))
+                marked.push_back(y);
+        for (int y : changed)
+            std::fill_n(row(changes, y), words, 0);
+
+        nearRows(marked, applying);
+        changed.clear();
+        for (int y : applying)
+            if (applyRow(y))
+                changed.push_back(y);
+
+        for (int y : marked) {
+            std::fill_n(row(clearing, y), words, 0);
+            std::fill_n(row(filling, y), words, 0);
+        }
+        nearRows(changed, counting);
+    }
+
+    Deductions result;
+    for (int y = 0; y < height; ++y) {
+        uint64_t* safeRow = row(safe, y);
+        uint64_t* mineRow = row(decided, y);
+        for (int w = 0; w < words; ++w) {
+            for (uint64_t bits = safeRow[w]; bits; bits &= bits - 1)
+                result.safe.push_back({w * 64 + std::countr_zero(bits), y});
+            for (uint64_t bits = mineRow[w]; bits; bits &= bits - 1)
+                result.mines.push_back({w * 64 + std::countr_zero(bits), y});
+        }
+    }
+    return result;
+}
+
+// chunks are 64 cells wide, so each chunk row span is exactly one plane word
+void BitboardSolver::load() {
+    width = grid->getGridWidth();
+    height = grid->getGridHeight();
+    words = (width + 63) / 64;
+    words = (words + LANE_WORDS - 1) / LANE_WORDS * LANE_WORDS;
+    stride = words + 2;
+
+    size_t size = static_cast<size_t>(height + 2) * stride;
+    for (std::vector<uint64_t>* plane : {&revealed, &open, &mines, &number[0], &number[1], &number[2], &number[3],
+                                         &clearing, &filling, &safe, &decided, &changes})
+        plane->assign(size, 0);
+    stamps.assign(height, 0);
+    stamp = 0;
+
+    SolverView view(*grid);
+    for (int y = 0; y < height; ++y) {
+        for (int chunkX = 0; chunkX < view.chunkColumns(); ++chunkX) {
+            TileSpan span = view.row(y, chunkX);
+            int columns = span.size;
+            // an untouched chunk is all unopened cells
+            if (span.untouched()) {
+                row(open, y)[chunkX] = columns == 64 ? ~uint64_t(0) : (uint64_t(1) << columns) - 1;
+                continue;
+            }
+
+            // most cells of a big board are still unopened, the span checks 8 of them at once
+            uint64_t shown = 0, unopened = 0, flags = 0, bits[4] = {0, 0, 0, 0};
+            for (int group = 0; group < columns; group += TILE_GROUP) {
+                int count = std::min(TILE_GROUP, columns - group);
+                if (count == TILE_GROUP && span.allBlank(group, TILE_GROUP)) {
+                    unopened |= uint64_t(0xff) << group;
+                    continue;
+                }
+
+                for (int localX = group; localX < group + count; ++localX) {
+                    TileId tile = span[localX];
+                    uint64_t bit = uint64_t(1) << localX;
+                    int number = TILE_NUMBERS[tile];
+                    if (number >= 0) {
+                        shown |= bit;
+                        for (int p = 0; p < 4; ++p)
+                            bits[p] |= static_cast<uint64_t>((number >> p) & 1) << localX;
+                    } else if (isMarkedTile(tile)) {
+                        flags |= bit;
+                    } else {
+                        unopened |= bit;
+                    }
+                }
+            }
+            row(revealed, y)[chunkX] = shown;
+            row(open, y)[chunkX] = unopened;
+            row(mines, y)[chunkX] = flags;
+            for (int p = 0; p < 4; ++p)
+                row(number[p], y)[chunkX] = bits[p];
+        }
+    }
+}
+
+// marks the numbers of row y that decide all their open neighbours
+// after the first pass only numbers next to a cell the last pass decided can have anything new to say
+// true when any number was marked
+bool BitboardSolver::countRow(int y, bool everything) {
+    const uint64_t* openAbove = row(open, y - 1);
+    const uint64_t* openMiddle = row(open, y);
+    const uint64_t* openBelow = row(open, y + 1);
+    const uint64_t* minesAbove = row(mines, y - 1);
+    const uint64_t* minesMiddle = row(mines, y);
+    const uint64_t* minesBelow = row(mines, y + 1);
+    const uint64_t* shown = row(revealed, y);
+    const uint64_t* changedAbove = row(changes, y - 1);
+    const uint64_t* changedMiddle = row(changes, y);
+    const uint64_t* changedBelow = row(changes, y + 1);
+    const uint64_t* numbers[4] = {row(number[0], y), row(number[1], y), row(number[2], y), row(number[3], y)};
+    uint64_t* clear = row(clearing, y);
+    uint64_t* fill = row(filling, y);
+
+    Lane any = zeroLane();
+    for (int w = 0; w < words; w += LANE_WORDS) {
+        Lane candidates = loadLane(shown + w);
+        if (!everything)
+            candidates = candidates & spread(changedAbove + w, changedMiddle + w, changedBelow + w);
+        if (!anySet(candidates))
+            continue;
+
+        Count unopened = countNeighbors(openAbove + w, openMiddle + w, openBelow + w);
+        candidates = candidates & (unopened.bit[0] | unopened.bit[1] | unopened.bit[2] | unopened.bit[3]);
+        if (!anySet(candidates))
+            continue;
+
+        Count found = countNeighbors(minesAbove + w, minesMiddle + w, minesBelow + w);
+        Count value;
+        for (int p = 0; p < 4; ++p)
+            value.bit[p] = loadLane(numbers[p] + w);
+
+        // number equals flags, the rest is safe, number equals flags plus open, the rest are mines
+        Lane clears = candidates & equal(value, found);
+        Lane fills = candidates & equal(value, add(found, unopened));
+        storeLane(clear + w, clears);
+        storeLane(fill + w, fills);
+        any = any | clears | fills;
+    }
+    return anySet(any);
+}
+
+// decides the open cells of row y next to a marked number, true when any were
+// a cell both cleared and filled means a wrong flag nearby, it is left open
+bool BitboardSolver::applyRow(int y) {
+    const uint64_t* clearAbove = row(clearing, y - 1);
+    const uint64_t* clearMiddle = row(clearing, y);
+    const uint64_t* clearBelow = row(clearing, y + 1);
+    const uint64_t* fillAbove = row(filling, y - 1);
+    const uint64_t* fillMiddle = row(filling, y);
+    const uint64_t* fillBelow = row(filling, y + 1);
+    uint64_t* unopened = row(open, y);
+    uint64_t* found = row(mines, y);
+    uint64_t* cleared = row(safe, y);
+    uint64_t* filled = row(decided, y);
+    uint64_t* changed = row(changes, y);
+
+    Lane any = zeroLane();
+    for (int w = 0; w < words; w += LANE_WORDS) {
+        Lane candidates = loadLane(unopened + w);
+        if (!anySet(candidates))
+            continue;
+
+        Lane toClear = candidates & spread(clearAbove + w, clearMiddle + w, clearBelow + w);
+        Lane toFill = candidates & spread(fillAbove + w, fillMiddle + w, fillBelow + w);
+        Lane both = toClear & toFill;
+        toClear = andNot(toClear, both);
+        toFill = andNot(toFill, both);
+        Lane decidedNow = toClear | toFill;
+        if (!anySet(decidedNow))
+            continue;
+
+        any = any | decidedNow;
+        storeLane(unopened + w, andNot(candidates, decidedNow));
+        storeLane(found + w, loadLane(found + w) | toFill);
+        storeLane(cleared + w, loadLane(cleared + w) | toClear);
+        storeLane(filled + w, loadLane(filled + w) | toFill);
+        storeLane(changed + w, decidedNow);
+    }
+    return anySet(any);
+}
+
+// rows from and their neighbours, each once and in order
+void BitboardSolver::nearRows(const std::vector<int>& from, std::vector<int>& to) {
+    to.clear();
+    stamp++;
+    for (int y : from) {
+        for (int near = std::max(0, y - 1); near <= std::min(height - 1, y + 1); ++near) {
+            if (stamps[near] == stamp)
+                continue;
+            stamps[near] = stamp;
+            to.push_back(near);
+        }
+    }
+    std::sort(to.begin(), to.end());
+}
+
+}  // namespace solver
@@ -0,0 +1,376 @@
+#include "headers/solver/constraints.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+
+#include "headers/utils/gridutils.h"
+
+namespace solver {
+
+namespace {
+
+// a group never has more than the 8 neighbours of one number
+constexpr int MAX_GROUP = 8;
+
+constexpr std::array<std::array<double, MAX_GROUP + 1>, MAX_GROUP + 1> makeChooseTable() {
+    std::array<std::array<double, MAX_GROUP + 1>, MAX_GROUP + 1> table{};
+    for (int n = 0; n <= MAX_GROUP; ++n) {
+        table[n][0] = 1.0;
+        for (int k = 1; k <= n; ++k)
+            table[n][k] = table[n - 1][k - 1] + (k < n ? table[n - 1][k] : 0.0);
+    }
+    return table;
+}
+
+constexpr auto CHOOSE = makeChooseTable();
+
+}  // namespace
+
+ConstraintEngine::ConstraintEngine(const Component& component) {
+    count = static_cast<int>(component.cells.size());
+    size_t rules = component.rules.size();
+    size_t ruleWords = (rules + 63) / 64;
+
+    std::vector<uint64_t> cellRules(count * ruleWords, 0);
+    for (size_t r = 0; r < rules; ++r)
+        for (int var : component.rules[r].vars)
+            cellRules[var * ruleWords + r / 64] |= uint64_t(1) << (r % 64);
+
+    // cells with the same rule mask collapse into one group, sorting puts equal masks next to each other
+    auto maskOf = [&](int cell) { return cellRules.begin() + cell * ruleWords; };
+    std::vector<int> byMask(count);
+    for (int cell = 0; cell < count; ++cell)
+        byMask[cell] = cell;
+    std::sort(byMask.begin(), byMask.end(), [&](int a, int b) {
+        return std::lexicographical_compare(maskOf(a), maskOf(a) + ruleWords, maskOf(b), maskOf(b) + ruleWords);
+    });
+
+    groupOf.resize(count);
+    for (int i = 0; i < count; ++i) {
+        int cell = byMask[i];
+        if (i == 0 || !std::equal(maskOf(cell), maskOf(cell) + ruleWords, maskOf(byMask[i - 1]))) {
+            groupSize.push_back(0);
+            groupRules.emplace_back();
+            for (size_t w = 0; w < ruleWords; ++w)
+                for (uint64_t bits = maskOf(cell)[w]; bits; bits &= bits - 1)
+                    groupRules.back().push_back(static_cast<int>(w * 64 + std::countr_zero(bits)));
+        }
+        groupOf[cell] = static_cast<int>(groupSize.size()) - 1;
+        groupSize.back()++;
+    }
+
+    size_t groups = groupSize.size();
+    ruleGroups.assign(rules, {});
+    for (size_t group = 0; group < groups; ++group)
+        for (int rule : groupRules[group])
+            ruleGroups[rule].push_back(static_cast<int>(group));
+
+    // breadth first over shared rules so every rule closes as soon as possible and prunes early
+    std::vector<uint8_t> seen(groups, 0);
+    for (size_t start = 0; start < groups; ++start) {
+        if (seen[start])
+            continue;
+        seen[start] = 1;
+        order.push_back(static_cast<int>(start));
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            for (int rule : groupRules[order[head]]) {
+                for (int group : ruleGroups[rule]) {
+                    if (!seen[group]) {
+                        seen[group] = 1;
+                        order.push_back(group);
+                    }
+                }
+            }
+        }
+    }
+
+    needed.resize(rules);
+    capacity.resize(rules);
+    for (size_t r = 0; r < rules; ++r) {
+        needed[r] = component.rules[r].mines;
+        capacity[r] = static_cast<int>(component.rules[r].vars.size());
+    }
+    ruleSize = capacity;
+}
+
+ComponentSolution ConstraintEngine::enumerate(uint64_t nodeBudget, Deadline deadline) {
+    ComponentSolution result;
+    this->nodeBudget = nodeBudget;
+    this->deadline = deadline;
+    begin(result);
+
+    search(0, 0, 1.0);
+
+    result.exact = !aborted;
+    finish(result);
+    return result;
+}
+
+ComponentSolution ConstraintEngine::sample(std::mt19937_64& gen, uint64_t maxSamples, Deadline deadline) {
+    ComponentSolution result;
+    this->nodeBudget = UINT64_MAX;
+    this->deadline = deadline;
+    begin(result);
+
+    // the clock is only read every few samples, a descent is a few microseconds
+    // past the deadline it keeps going until one descent got through, up to a limit, or there is no estimate at all
+    uint64_t leaves = 0;
+    while (result.samples < maxSamples) {
+        if (result.samples % 64 == 0 && std::chrono::steady_clock::now() >= deadline &&
+            (leaves > 0 || result.samples >= 512))
+            break;
+
+        leaves += descend(gen);
+        result.samples++;
+    }
+
+    result.exact = false;
+    finish(result);
+    return result;
+}
+
+void ConstraintEngine::sampleInto(SampleTally& tally, std::mt19937_64& gen, uint64_t descents, int exponent) {
+    if (tally.ways.empty()) {
+        tally.ways.assign(count + 1, 0.0);
+        tally.groupWays.assign(count + 1, {});
+        tally.groupClear.assign(count + 1, {});
+    }
+
+    // record writes into the engine's own totals, borrow the tally's for the duration
+    ComponentSolution borrowed;
+    borrowed.ways.swap(tally.ways);
+    groupWays.swap(tally.groupWays);
+    groupClear.swap(tally.groupClear);
+    solution = &borrowed;
+    weightScale = std::ldexp(1.0, exponent);
+    if (placed.size() != needed.size())
+        resetBranch();
+
+    for (uint64_t i = 0; i < descents; ++i) {
+        tally.leaves += descend(gen);
+        tally.samples++;
+    }
+
+    weightScale = 1.0;
+    solution = nullptr;
+    borrowed.ways.swap(tally.ways);
+    groupWays.swap(tally.groupWays);
+    groupClear.swap(tally.groupClear);
+}
+
+ComponentSolution ConstraintEngine::finishTally(SampleTally& tally) {
+    ComponentSolution result;
+    result.ways = tally.ways.empty() ? std::vector<double>(count + 1, 0.0) : tally.ways;
+    result.samples = tally.samples;
+    result.exact = false;
+    groupWays = tally.groupWays;
+    groupClear = tally.groupClear;
+    groupWays.resize(count + 1);
+    groupClear.resize(count + 1);
+    solution = &result;
+    finish(result);
+    return result;
+}
+
+void ConstraintEngine::begin(ComponentSolution& result) {
+    result.ways.assign(count + 1, 0.0);
+    solution = &result;
+    nodes = 0;
+    aborted = false;
+    resetBranch();
+    groupWays.assign(count + 1, {});
+    groupClear.assign(count + 1, {});
+}
+
+void ConstraintEngine::resetBranch() {
+    size_t groups = groupSize.size();
+    placed.assign(needed.size(), 0);
+    capacity = ruleSize;
+    chosen.assign(groups, 0);
+    assigned.assign(groups, 0);
+}
+
+void ConstraintEngine::finish(ComponentSolution& result) {
+    // every cell of a group carries the same share of the group's mines
+    // only mine counts that actually occur get a row, most of 0..count never do
+    while (result.minMines <= count && result.ways[result.minMines] == 0.0)
+        result.minMines++;
+    result.maxMines = count;
+    while (result.maxMines >= result.minMines && result.ways[result.maxMines] == 0.0)
+        result.maxMines--;
+
+    size_t rows = static_cast<size_t>(result.maxMines - result.minMines + 1);
+    result.cellWays.assign(rows * count, 0.0);
+    result.clearSeen.assign(rows * count, 0);
+    for (int m = result.minMines; m <= result.maxMines; ++m) {
+        if (groupWays[m].empty())
+            continue;
+        size_t row = static_cast<size_t>(m - result.minMines) * count;
+        for (int cell = 0; cell < count; ++cell) {
+            int group = groupOf[cell];
+            result.cellWays[row + cell] = groupWays[m][group] / groupSize[group];
+            result.clearSeen[row + cell] = groupClear[m][group];
+        }
+    }
+
+    solution = nullptr;
+}
+
+void ConstraintEngine::record(int mines, double weight) {
+    size_t groups = groupSize.size();
+    solution->ways[mines] += weight;
+    std::vector<double>& ways = groupWays[mines];
+    std::vector<uint8_t>& clear = groupClear[mines];
+    if (ways.empty()) {
+        ways.assign(groups, 0.0);
+        clear.assign(groups, 0);
+    }
+    for (size_t group = 0; group < groups; ++group) {
+        ways[group] += weight * chosen[group];
+        clear[group] |= chosen[group] < groupSize[group];
+    }
+}
+
+void ConstraintEngine::search(size_t depth, int mines, double weight) {
+    if (aborted)
+        return;
+    if (++nodes > nodeBudget || (nodes % 4096 == 0 && std::chrono::steady_clock::now() >= deadline)) {
+        aborted = true;
+        return;
+    }
+
+    if (depth == order.size()) {
+        record(mines, weight);
+        return;
+    }
+
+    // every rule of the group bounds its mine count, no branch below can fail on these rules
+    int group = order[depth];
+    int size = groupSize[group];
+    int low = 0;
+    int high = size;
+    for (int rule : groupRules[group]) {
+        capacity[rule] -= size;
+        low = std::max(low, needed[rule] - placed[rule] - capacity[rule]);
+        high = std::min(high, needed[rule] - placed[rule]);
+    }
+
+    for (int take = low; take <= high; ++take) {
+        for (int rule : groupRules[group])
+            placed[rule] += take;
+        chosen[group] = take;
+        search(depth + 1, mines + take, weight * CHOOSE[size][take]);
+        for (int rule : groupRules[group])
+            placed[rule] -= take;
+    }
+
+    chosen[group] = 0;
+    for (int rule : groupRules[group])
+        capacity[rule] += size;
+}
+
+bool ConstraintEngine::descend(std::mt19937_64& gen) {
+    int mines = 0;
+    double weight = weightScale;
+    size_t depth = 0;
+    bool alive = true;
+    for (; depth < order.size(); ++depth) {
+        int group = order[depth];
+        int size = groupSize[group];
+        int low = 0;
+        int high = size;
+        for (int rule : groupRules[group]) {
+            capacity[rule] -= size;
+            low = std::max(low, needed[rule] - placed[rule] - capacity[rule]);
+            high = std::min(high, needed[rule] - placed[rule]);
+        }
+
+        // pick a count in proportion to its fillings, the weight makes up for the ones not picked
+        double total = 0.0;
+        std::array<double, MAX_GROUP + 1> viableWeight{};
+        for (int take = low; take <= high; ++take) {
+            if (viable(group, take)) {
+                viableWeight[take] = CHOOSE[size][take];
+                total += viableWeight[take];
+            }
+        }
+        if (total == 0.0) {
+            alive = false;
+            depth++;
+            break;
+        }
+
+        double pick = static_cast<double>(gen() >> 11) * 0x1.0p-53 * total;
+        int take = low;
+        for (int candidate = low; candidate <= high; ++candidate) {
+            if (viableWeight[candidate] == 0.0)
+                continue;
+            take = candidate;
+            if (pick < viableWeight[candidate])
+                break;
+            pick -= viableWeight[candidate];
+        }
+        assigned[group] = 1;
+
+        for (int rule : groupRules[group])
+            placed[rule] += take;
+        chosen[group] = take;
+        mines += take;
+        weight *= total;
+    }
+
+    // a dead end still counts as a sample, it is what keeps the estimate unbiased
+    if (alive)
+        record(mines, weight);
+
+    // leave the counters as they were for the next descent
+    while (depth-- > 0) {
+        int group = order[depth];
+        for (int rule : groupRules[group]) {
+            placed[rule] -= chosen[group];
+            capacity[rule] += groupSize[group];
+        }
+        chosen[group] = 0;
+        assigned[group] = 0;
+    }
+    return alive;
+}
+
+bool ConstraintEngine::viable(int group, int take) {
+    for (int rule : groupRules[group])
+        placed[rule] += take;
+
+    // every unassigned group sharing a rule must still have some count that fits all of its rules
+    bool fits = true;
+    for (size_t r = 0; r < groupRules[group].size() && fits; ++r) {
+        for (int other : ruleGroups[groupRules[group][r]]) {
+            if (other == group || assigned[other])
+                continue;
+            int size = groupSize[other];
+            int low = 0;
+            int high = size;
+            for (int rule : groupRules[other]) {
+                low = std::max(low, needed[rule] - placed[rule] - (capacity[rule] - size));
+                high = std::min(high, needed[rule] - placed[rule]);
+            }
+            if (low > high) {
+                fits = false;
+                break;
+            }
+        }
+    }
+
+    for (int rule : groupRules[group])
+        placed[rule] -= take;
+    return fits;
+}
+
+ComponentSolution enumerateComponent(const Component& component, uint64_t nodeBudget) {
+    ConstraintEngine engine(component);
+    return engine.enumerate(nodeBudget);
+}
+
+}  // namespace solver
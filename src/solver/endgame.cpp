@@ -0,0 +1,392 @@
+#include "headers/solver/endgame.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "headers/solver/view.h"
+
+namespace solver {
+
+namespace {
+
+constexpr int CHOOSE_SIZE = EndgameSolver::MAX_UNKNOWNS + 1;
+
+constexpr std::array<std::array<double, CHOOSE_SIZE>, CHOOSE_SIZE> makeChooseTable() {
+    std::array<std::array<double, CHOOSE_SIZE>, CHOOSE_SIZE> table{};
+    for (int n = 0; n < CHOOSE_SIZE; ++n) {
+        table[n][0] = 1.0;
+        for (int k = 1; k <= n; ++k)
+            table[n][k] = table[n - 1][k - 1] + (k < n ? table[n - 1][k] : 0.0);
+    }
+    return table;
+}
+
+constexpr auto CHOOSE = makeChooseTable();
+
+double choose(int n, int k) {
+    return n < 0 || k < 0 || k > n ? 0.0 : CHOOSE[n][k];
+}
+
+}  // namespace
+
+EndgameSolver::EndgameSolver(Grid* grid) {
+    this->grid = grid;
+}
+
+bool EndgameSolver::solve(ProbabilityMap& result) {
+    placements = 0;
+    nodes = 0;
+    bestGuessEntropy = 0.0;
+    if (!collect())
+        return false;
+
+    found.assign(frontierCount + 1, 0);
+    counts.assign(frontierCount + 1, Counter{});
+    stored.clear();
+    overflow = false;
+    search(0, 0, 0);
+    if (nodes > nodeBudget || placements == 0)
+        return false;
+
+    // completions[k], ways to fill the interior when the frontier holds k mines
+    std::vector<double> completions(frontierCount + 1, 0.0);
+    double total = 0.0;
+    for (int k = 0; k <= frontierCount; ++k) {
+        if (found[k] == 0)
+            continue;
+        completions[k] = choose(interiorCount, minesLeft - k);
+        total += static_cast<double>(found[k]) * completions[k];
+    }
+
+    ProbabilityMap map;
+    map.exact = true;
+    map.interiorCells = interiorCount;
+    int width = grid->getGridWidth();
+    std::vector<double> probability(cells.size(), 0.0);
+
+    // counts are exact integers, so certainty does not depend on float equality
+    for (int cell = 0; cell < frontierCount; ++cell) {
+        double mineWays = 0.0;
+        bool alwaysClear = true;
+        bool alwaysMine = true;
+        for (int k = 0; k <= frontierCount; ++k) {
+            if (completions[k] == 0.0)
+                continue;
+            uint64_t count = 0;
+            for (int p = 0; p < PLANES; ++p)
+                count |= ((counts[k][p] >> cell) & 1) << p;
+            mineWays += static_cast<double>(count) * completions[k];
+            alwaysClear = alwaysClear && count == 0;
+            alwaysMine = alwaysMine && count == found[k];
+        }
+
+        probability[cell] = mineWays / total;
+        map.frontier[cellKey(cells[cell].x, cells[cell].y, width)] = probability[cell];
+        if (alwaysClear)
+            map.certain.safe.push_back(cells[cell]);
+        else if (alwaysMine)
+            map.certain.mines.push_back(cells[cell]);
+    }
+
+    if (interiorCount > 0) {
+        double mineWays = 0.0;
+        bool alwaysClear = true;
+        bool alwaysMine = true;
+        for (int k = 0; k <= frontierCount; ++k) {
+            if (completions[k] == 0.0)
+                continue;
+            int rest = minesLeft - k;
+            mineWays += static_cast<double>(found[k]) * completions[k] * rest / interiorCount;
+            alwaysClear = alwaysClear && rest == 0;
+            alwaysMine = alwaysMine && rest == interiorCount;
+        }
+
+        map.interiorProbability = mineWays / total;
+        for (size_t cell = frontierCount; cell < cells.size(); ++cell) {
+            probability[cell] = map.interiorProbability;
+            if (alwaysClear)
+                map.certain.safe.push_back(cells[cell]);
+            else if (alwaysMine)
+                map.certain.mines.push_back(cells[cell]);
+        }
+    }
+
+    // safest first, a cell whose number has more possible values narrows the rest down faster
+    std::vector<int> safest;
+    double lowest = 1.0;
+    for (size_t cell = 0; cell < cells.size(); ++cell) {
+        if (probability[cell] < lowest - 1e-12) {
+            lowest = probability[cell];
+            safest.clear();
+        }
+        if (probability[cell] <= lowest + 1e-12)
+            safest.push_back(static_cast<int>(cell));
+    }
+
+    int best = safest.front();
+    if (safest.size() > 1 && !overflow) {
+        double most = -1.0;
+        for (int cell : safest) {
+            double entropy = entropyOf(cell, completions);
+            if (entropy > most + 1e-12) {
+                most = entropy;
+                best = cell;
+            }
+        }
+        bestGuessEntropy = most;
+    } else if (!overflow) {
+        bestGuessEntropy = entropyOf(best, completions);
+    }
+    map.bestGuess = cells[best];
+    map.bestGuessProbability = probability[best];
+
+    result = std::move(map);
+    return true;
+}
+
+bool EndgameSolver::collect() {
+    SolverView view(*grid);
+    int width = view.width();
+    int height = view.height();
+    int limit = std::min(maxUnknowns, MAX_UNKNOWNS);
+
+    // a big board is only ever scanned near its end, unknowns never drop below open cells minus mines
+    // unless there are more flags than mines, and then there is nothing sound to say anyway
+    int64_t area = static_cast<int64_t>(width) * height;
+    if (area - grid->revealedSafeCells - grid->totalMines > limit)
+        return false;
+
+    std::vector<CellPos> open;
+    std::vector<int64_t> openKeys;
+    int64_t flagged = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int chunkX = 0; chunkX < view.chunkColumns(); ++chunkX) {
+            TileSpan span = view.row(y, chunkX);
+            // an untouched span is all open, and far more than the limit allows
+            if (span.untouched() && static_cast<int>(open.size()) + span.size > limit)
+                return false;
+            for (int i = 0; i < span.size; ++i) {
+                TileId tile = span[i];
+                if (isMarkedTile(tile)) {
+                    flagged++;
+                } else if (isOpenTile(tile)) {
+                    if (static_cast<int>(open.size()) == limit)
+                        return false;
+                    open.push_back({span.firstX + i, y});
+                    openKeys.push_back(cellKey(span.firstX + i, y, width));
+                }
+            }
+        }
+    }
+
+    int64_t left = grid->totalMines - flagged;
+    if (left < 0 || left > static_cast<int64_t>(open.size()))
+        return false;
+    minesLeft = static_cast<int>(left);
+
+    // scanned in key order, so the keys are sorted
+    auto indexOf = [&](int64_t key) {
+        return static_cast<int>(std::lower_bound(openKeys.begin(), openKeys.end(), key) - openKeys.begin());
+    };
+
+    std::vector<int64_t> numbers;
+    for (CellPos cell : open) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = cell.x + dx;
+                int ny = cell.y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+                    continue;
+                if (view.number(nx, ny) >= 0)
+                    numbers.push_back(cellKey(nx, ny, width));
+            }
+        }
+    }
+    std::sort(numbers.begin(), numbers.end());
+    numbers.erase(std::unique(numbers.begin(), numbers.end()), numbers.end());
+
+    // rules over the scan order first, renumbered into search order below
+    std::vector<Rule> scanned;
+    uint64_t frontier = 0;
+    for (int64_t key : numbers) {
+        int x = static_cast<int>(key % width);
+        int y = static_cast<int>(key / width);
+        Rule rule{0, view.number(x, y)};
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+                    continue;
+                TileId neighbor = view.tile(nx, ny);
+                if (isMarkedTile(neighbor))
+                    rule.mines--;
+                else if (isOpenTile(neighbor))
+                    rule.mask |= uint64_t(1) << indexOf(cellKey(nx, ny, width));
+            }
+        }
+
+        if (rule.mines < 0 || rule.mines > std::popcount(rule.mask))
+            return false;
+        frontier |= rule.mask;
+        scanned.push_back(rule);
+    }
+
+    // breadth first over shared rules so rules close early and prune, interior cells go last
+    std::vector<int> order;
+    std::vector<uint8_t> seen(open.size(), 0);
+    for (int start = 0; start < static_cast<int>(open.size()); ++start) {
+        if (!((frontier >> start) & 1) || seen[start])
+            continue;
+        seen[start] = 1;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            for (const Rule& rule : scanned) {
+                if (!((rule.mask >> order[head]) & 1))
+                    continue;
+                for (uint64_t bits = rule.mask; bits; bits &= bits - 1) {
+                    int cell = std::countr_zero(bits);
+                    if (!seen[cell]) {
+                        seen[cell] = 1;
+                        order.push_back(cell);
+                    }
+                }
+            }
+        }
+    }
+    frontierCount = static_cast<int>(order.size());
+    for (int cell = 0; cell < static_cast<int>(open.size()); ++cell)
+        if (!seen[cell])
+            order.push_back(cell);
+    interiorCount = static_cast<int>(order.size()) - frontierCount;
+
+    std::vector<int> position(open.size());
+    cells.clear();
+    for (size_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = static_cast<int>(i);
+        cells.push_back(open[order[i]]);
+    }
+    auto remap = [&](uint64_t mask) {
+        uint64_t result = 0;
+        for (; mask; mask &= mask - 1)
+            result |= uint64_t(1) << position[std::countr_zero(mask)];
+        return result;
+    };
+
+    rules.clear();
+    cellRules.assign(frontierCount, {});
+    for (const Rule& rule : scanned) {
+        rules.push_back({remap(rule.mask), rule.mines});
+        for (uint64_t bits = rules.back().mask; bits; bits &= bits - 1)
+            cellRules[std::countr_zero(bits)].push_back(static_cast<int>(rules.size()) - 1);
+    }
+
+    neighborMask.assign(cells.size(), 0);
+    interiorNeighbors.assign(cells.size(), 0);
+    for (size_t i = 0; i < cells.size(); ++i) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = cells[i].x + dx;
+                int ny = cells[i].y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+                    continue;
+                int64_t key = cellKey(nx, ny, width);
+                auto it = std::lower_bound(openKeys.begin(), openKeys.end(), key);
+                if (it == openKeys.end() || *it != key)
+                    continue;
+                int neighbor = position[it - openKeys.begin()];
+                if (neighbor < frontierCount)
+                    neighborMask[i] |= uint64_t(1) << neighbor;
+                else
+                    interiorNeighbors[i]++;
+            }
+        }
+    }
+
+    return true;
+}
+
+// bit depth decides cells[depth], every rule touching it is checked against what the lower bits placed
+void EndgameSolver::search(int depth, uint64_t mines, int placed) {
+    if (++nodes > nodeBudget)
+        return;
+
+    if (depth == frontierCount) {
+        int rest = minesLeft - placed;
+        if (rest < 0 || rest > interiorCount)
+            return;
+
+        // bit sliced add, plane p of the counter is bit p of every cell's count
+        Counter& counter = counts[placed];
+        uint64_t carry = mines;
+        for (int p = 0; carry && p < PLANES; ++p) {
+            uint64_t next = counter[p] & carry;
+            counter[p] ^= carry;
+            carry = next;
+        }
+        found[placed]++;
+        placements++;
+        if (stored.size() < maxStored)
+            stored.push_back(mines);
+        else
+            overflow = true;
+        return;
+    }
+
+    uint64_t undecided = ~((uint64_t(2) << depth) - 1);
+    int after = frontierCount - depth - 1;
+    for (int bit = 0; bit <= 1; ++bit) {
+        int total = placed + bit;
+        if (total > minesLeft)
+            break;
+        if (total + after + interiorCount < minesLeft)
+            continue;
+
+        uint64_t next = mines | (uint64_t(bit) << depth);
+        bool fits = true;
+        for (int rule : cellRules[depth]) {
+            int have = std::popcount(next & rules[rule].mask);
+            int room = std::popcount(rules[rule].mask & undecided);
+            if (have > rules[rule].mines || have + room < rules[rule].mines) {
+                fits = false;
+                break;
+            }
+        }
+        if (fits)
+            search(depth + 1, next, total);
+        if (nodes > nodeBudget)
+            return;
+    }
+}
+
+// entropy in bits of the number revealed under cell, over every placement that leaves cell clear
+// interior neighbours are not enumerated, their mines follow a hypergeometric count per placement
+double EndgameSolver::entropyOf(int cell, const std::vector<double>& completions) {
+    std::array<double, 9> outcomes{};
+    bool interior = cell >= frontierCount;
+    int near = interiorNeighbors[cell];
+    int far = interiorCount - near - (interior ? 1 : 0);
+
+    for (uint64_t mines : stored) {
+        if (!interior && ((mines >> cell) & 1))
+            continue;
+        int rest = minesLeft - std::popcount(mines);
+        if (completions[std::popcount(mines)] == 0.0)
+            continue;
+        int seen = std::popcount(mines & neighborMask[cell]);
+        for (int hidden = 0; hidden <= near && hidden <= rest; ++hidden)
+            outcomes[seen + hidden] += choose(near, hidden) * choose(far, rest - hidden);
+    }
+
+    double total = 0.0;
+    for (double value : outcomes)
+        total += value;
+    double entropy = 0.0;
+    for (double value : outcomes)
+        if (value > 0.0)
+            entropy -= value / total * std::log2(value / total);
+    return entropy;
+}
+
+}  // namespace solver
@@ -0,0 +1,166 @@
+#include "headers/solver/hints.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "headers/solver/anytime.h"
+#include "headers/solver/view.h"
+
+namespace solver {
+
+namespace {
+
+// probability to a heat byte, 0 is kept for cells with nothing to show
+uint8_t heatByte(double probability) {
+    return static_cast<uint8_t>(1 + std::lround(std::clamp(probability, 0.0, 1.0) * 254.0));
+}
+
+std::vector<uint8_t> heatOf(const Grid& board, const ProbabilityMap& result) {
+    std::vector<uint8_t> heat(static_cast<size_t>(board.width) * board.height, 0);
+    uint8_t interior = heatByte(result.interiorProbability);
+    SolverView view(board);
+    view.forEachTile(0, 0, board.width, board.height, [&](int x, int y, TileId tile) {
+        if (isOpenTile(tile))
+            heat[static_cast<size_t>(y) * board.width + x] = interior;
+    });
+    for (const auto& [cell, probability] : result.frontier)
+        heat[cell] = heatByte(probability);
+    return heat;
+}
+
+}  // namespace
+
+HintWorker::HintWorker(std::chrono::microseconds budget, unsigned samplerThreads)
+    : budget(budget),
+      sampler(samplerThreads > 0 ? std::make_unique<MonteCarloEstimator>(samplerThreads) : nullptr),
+      thread(&HintWorker::run, this) {}
+
+HintWorker::~HintWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+const Hint* HintWorker::poll(const Grid& grid) {
+    // nothing to work out before the first click or once the game is over
+    if (grid.firstClick || grid.gameState != GameState::ONGOING)
+        return nullptr;
+
+    uint64_t hash = grid.visibleHash;
+    if (!submitted || hash != submittedHash) {
+        submitted = true;
+        submittedHash = hash;
+        std::unique_ptr<Snapshot> snapshot = takeSnapshot(grid);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = std::move(snapshot);
+        }
+        wake.notify_one();
+    }
+
+    if (published.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(current, ready);
+        hasCurrent = true;
+        published.store(false, std::memory_order_relaxed);
+    }
+    return hasCurrent && current.visibleHash == hash ? &current : nullptr;
+}
+
+void HintWorker::setHeatmap(bool enabled) {
+    if (heatmap.exchange(enabled, std::memory_order_relaxed) != enabled && enabled)
+        submitted = false;
+}
+
+std::unique_ptr<HintWorker::Snapshot> HintWorker::takeSnapshot(const Grid& grid) {
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->width = grid.width;
+    snapshot->height = grid.height;
+    snapshot->numMine = grid.numMine;
+    snapshot->layout = grid.cellLayout;
+    snapshot->totalMines = grid.totalMines;
+    snapshot->revealedSafeCells = grid.revealedSafeCells;
+    snapshot->visibleHash = grid.visibleHash;
+
+    Chunk* const* table = grid.chunks.tableData();
+    size_t chunkCount = grid.chunks.chunkCount();
+    for (size_t index = 0; index < chunkCount; ++index) {
+        const Chunk* chunk = table[index];
+        if (!chunk)
+            continue;
+        if (snapshot->chunkIndices.size() == MAX_SNAPSHOT_CHUNKS)
+            return nullptr;
+
+        snapshot->chunkIndices.push_back(index);
+        size_t offset = snapshot->tiles.size();
+        snapshot->tiles.resize(offset + CHUNK_CELLS);
+        for (int cell = 0; cell < CHUNK_CELLS; ++cell)
+            snapshot->tiles[offset + cell] = chunk->cells[cell].renderTile;
+    }
+    return snapshot;
+}
+
+Hint HintWorker::solve(const Snapshot& snapshot) {
+    // a grid of tiles only, solvers read nothing but renderTile so no mines are needed under them
+    GridMetadata metadata = {snapshot.width, snapshot.height, snapshot.numMine, 0, -1, -1};
+    GridStorageOptions storage;
+    storage.layout = snapshot.layout;
+    Grid board(metadata, "", false, storage);
+    board.firstClick = false;
+    board.boardGenerated = true;
+    board.totalMines = snapshot.totalMines;
+    board.revealedSafeCells = snapshot.revealedSafeCells;
+    board.visibleHash = snapshot.visibleHash;
+    for (size_t i = 0; i < snapshot.chunkIndices.size(); ++i) {
+        Chunk* chunk = board.chunks.create(snapshot.chunkIndices[i]);
+        const TileId* tiles = &snapshot.tiles[i * CHUNK_CELLS];
+        for (int cell = 0; cell < CHUNK_CELLS; ++cell)
+            chunk->cells[cell].renderTile = tiles[cell];
+    }
+
+    bool withHeat = heatmap.load(std::memory_order_relaxed);
+    AnytimeSolver solver(&board, sampler.get());
+    solver.probabilities.transpositions = &transpositions;
+    ProbabilityMap result = withHeat ? solver.probabilities.solveWithin(budget) : solver.solve(budget);
+    // the rules can come back with mines alone, or with nothing once a huge opening runs them out of budget,
+    // neither says where to click
+    if (result.certain.safe.empty() && result.bestGuess.x < 0)
+        result = solver.probabilities.solveWithin(budget);
+
+    Hint hint;
+    hint.visibleHash = snapshot.visibleHash;
+    if (withHeat)
+        hint.heat = heatOf(board, result);
+    hint.safe = std::move(result.certain.safe);
+    if (hint.safe.empty()) {
+        hint.guess = result.bestGuess;
+        hint.guessProbability = result.bestGuessProbability;
+    }
+    return hint;
+}
+
+void HintWorker::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || pending; });
+        if (stopping)
+            return;
+
+        std::unique_ptr<Snapshot> snapshot = std::move(pending);
+        lock.unlock();
+        Hint hint = solve(*snapshot);
+        lock.lock();
+
+        // the board moved on while this was solved, the newer one is already waiting
+        if (pending)
+            continue;
+        ready = std::move(hint);
+        published.store(true, std::memory_order_release);
+    }
+}
+
+}  // namespace solver
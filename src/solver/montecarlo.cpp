@@ -0,0 +1,265 @@
+#include "headers/solver/montecarlo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace solver {
+
+namespace {
+
+// past the deadline sampling goes on until a descent got through or this many were drawn, same as the serial sampler
+constexpr uint64_t DEADLINE_FLOOR = 512;
+// the spread between fewer batches than this says too little to stop on
+constexpr uint64_t MIN_BATCHES = 8;
+// a merge costs about one pass over the groups per mine count the batch hit, a descent about one pass as well,
+// so a batch runs this many descents per mine count before it is worth merging
+constexpr uint64_t DESCENTS_PER_ROW = 16;
+
+uint64_t rowsHit(const SampleTally& tally) {
+    return static_cast<uint64_t>(std::count_if(tally.ways.begin(), tally.ways.end(), [](double value) { return value != 0.0; }));
+}
+
+}  // namespace
+
+MonteCarloEstimator::MonteCarloEstimator(unsigned threads, uint64_t seed) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // streams are built before any thread starts, the vector never moves after
+    for (unsigned i = 0; i < threads; ++i) {
+        std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), i};
+        streams.emplace_back(sequence);
+    }
+    for (unsigned i = 0; i < threads; ++i)
+        workers.emplace_back(&MonteCarloEstimator::work, this, i);
+}
+
+MonteCarloEstimator::~MonteCarloEstimator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quitting = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+ComponentSolution MonteCarloEstimator::estimate(const Component& component, uint64_t maxSamples, Deadline deadline,
+                                                double targetError) {
+    ConstraintEngine engine(component);
+    size_t mineCounts = static_cast<size_t>(engine.cellCount() + 1);
+
+    // a short serial pilot picks the weight scale so its leaves land near 1, the workers all use the same one
+    // without leaves the scale is a guess halfway into the 2^cells range a weight can reach
+    SampleTally pilot;
+    while (pilot.leaves == 0 && pilot.samples < DEADLINE_FLOOR)
+        engine.sampleInto(pilot, streams.front(), 8);
+    int scale = -engine.cellCount() / 2;
+    if (pilot.leaves > 0) {
+        double total = 0.0;
+        for (double value : pilot.ways)
+            total += value;
+        scale = -std::ilogb(total);
+    }
+    for (double& value : pilot.ways)
+        value = std::ldexp(value, scale);
+    for (std::vector<double>& row : pilot.groupWays)
+        for (double& value : row)
+            value = std::ldexp(value, scale);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->component = &component;
+        this->maxSamples = maxSamples;
+        this->deadline = deadline;
+        this->targetError = targetError;
+        exponent = scale;
+        groups = engine.groupCount();
+        groupCells.resize(groups);
+        for (size_t group = 0; group < groups; ++group)
+            groupCells[group] = engine.groupCells(group);
+
+        ways = std::vector<std::atomic<double>>(mineCounts);
+        rows = std::vector<std::atomic<SharedRow*>>(mineCounts);
+        sumC = std::vector<std::atomic<double>>(groups);
+        sumCC = std::vector<std::atomic<double>>(groups);
+        sumCW = std::vector<std::atomic<double>>(groups);
+        sumW = 0.0;
+        sumWW = 0.0;
+        samples = 0;
+        leaves = 0;
+        batches = 0;
+        converged = false;
+        stopping = false;
+    }
+
+    std::vector<double> batchGroups(groups, 0.0);
+    merge(pilot, batchGroups);
+    stopping = shouldStop();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        running = static_cast<unsigned>(workers.size());
+        generation++;
+        wake.notify_all();
+        idle.wait(lock, [this] { return running == 0; });
+    }
+
+    // every worker is parked again, the totals are final
+    SampleTally merged;
+    merged.ways.resize(mineCounts);
+    merged.groupWays.resize(mineCounts);
+    merged.groupClear.resize(mineCounts);
+    for (size_t m = 0; m < mineCounts; ++m) {
+        merged.ways[m] = ways[m].load(std::memory_order_relaxed);
+        SharedRow* row = rows[m].exchange(nullptr);
+        if (!row)
+            continue;
+        for (size_t group = 0; group < groups; ++group) {
+            merged.groupWays[m].push_back(row->groupWays[group].load(std::memory_order_relaxed));
+            merged.groupClear[m].push_back(row->groupClear[group].load(std::memory_order_relaxed));
+        }
+        delete row;
+    }
+    merged.samples = samples;
+    merged.leaves = leaves;
+
+    stats.samples = samples;
+    stats.leaves = leaves;
+    stats.batches = batches;
+    stats.standardError = standardError();
+    stats.converged = converged;
+    this->component = nullptr;
+    return engine.finishTally(merged);
+}
+
+void MonteCarloEstimator::work(unsigned index) {
+    std::mt19937_64& gen = streams[index];
+    uint64_t seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quitting || generation != seen; });
+            if (quitting)
+                return;
+            seen = generation;
+        }
+
+        if (!stopping.load(std::memory_order_relaxed)) {
+            ConstraintEngine engine(*component);
+            SampleTally tally;
+            std::vector<double> batchGroups(groups, 0.0);
+            while (!stopping.load(std::memory_order_relaxed)) {
+                engine.sampleInto(tally, gen, batchSize, exponent);
+                bool limit = std::chrono::steady_clock::now() >= deadline ||
+                             samples.load(std::memory_order_relaxed) + tally.samples >= maxSamples;
+                if (!limit && tally.samples < DESCENTS_PER_ROW * rowsHit(tally))
+                    continue;
+                merge(tally, batchGroups);
+                if (shouldStop())
+                    stopping.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0)
+                idle.notify_all();
+        }
+    }
+}
+
+// adds a batch into the shared totals and empties it for the next one
+void MonteCarloEstimator::merge(SampleTally& tally, std::vector<double>& batchGroups) {
+    double total = 0.0;
+    for (size_t m = 0; m < tally.ways.size(); ++m) {
+        if (tally.ways[m] == 0.0)
+            continue;
+
+        total += tally.ways[m];
+        ways[m].fetch_add(tally.ways[m], std::memory_order_relaxed);
+        SharedRow* row = rowFor(m);
+        std::vector<double>& local = tally.groupWays[m];
+        std::vector<uint8_t>& clear = tally.groupClear[m];
+        for (size_t group = 0; group < groups; ++group) {
+            if (local[group] != 0.0) {
+                row->groupWays[group].fetch_add(local[group], std::memory_order_relaxed);
+                batchGroups[group] += local[group];
+                local[group] = 0.0;
+            }
+            // clear flags only ever go up, once set nobody needs to write them again
+            if (clear[group] && !row->groupClear[group].load(std::memory_order_relaxed))
+                row->groupClear[group].store(1, std::memory_order_relaxed);
+        }
+        tally.ways[m] = 0.0;
+    }
+
+    for (size_t group = 0; group < groups; ++group) {
+        double mines = batchGroups[group];
+        if (mines == 0.0)
+            continue;
+        sumC[group].fetch_add(mines, std::memory_order_relaxed);
+        sumCC[group].fetch_add(mines * mines, std::memory_order_relaxed);
+        sumCW[group].fetch_add(mines * total, std::memory_order_relaxed);
+        batchGroups[group] = 0.0;
+    }
+    sumW.fetch_add(total, std::memory_order_relaxed);
+    sumWW.fetch_add(total * total, std::memory_order_relaxed);
+
+    samples.fetch_add(tally.samples, std::memory_order_relaxed);
+    leaves.fetch_add(tally.leaves, std::memory_order_relaxed);
+    batches.fetch_add(1, std::memory_order_relaxed);
+    tally.samples = 0;
+    tally.leaves = 0;
+}
+
+MonteCarloEstimator::SharedRow* MonteCarloEstimator::rowFor(size_t mines) {
+    SharedRow* row = rows[mines].load(std::memory_order_acquire);
+    if (row)
+        return row;
+
+    // two threads can race to the same new row, the loser drops its copy and takes the winner's
+    SharedRow* fresh = new SharedRow(groups);
+    if (rows[mines].compare_exchange_strong(row, fresh, std::memory_order_acq_rel))
+        return fresh;
+    delete fresh;
+    return row;
+}
+
+bool MonteCarloEstimator::shouldStop() {
+    uint64_t drawn = samples.load(std::memory_order_relaxed);
+    if (drawn >= maxSamples)
+        return true;
+    if (std::chrono::steady_clock::now() >= deadline &&
+        (leaves.load(std::memory_order_relaxed) > 0 || drawn >= DEADLINE_FLOOR))
+        return true;
+    if (targetError > 0.0 && batches.load(std::memory_order_relaxed) >= MIN_BATCHES && standardError() <= targetError) {
+        converged.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// ratio estimator over batches, var(C/W) ~ B / (B - 1) * sum (C_b - q W_b)^2 / (sum W)^2
+// the totals may be a merge or two apart while other threads add, close enough to decide when to stop
+double MonteCarloEstimator::standardError() const {
+    double count = static_cast<double>(batches.load(std::memory_order_relaxed));
+    double total = sumW.load(std::memory_order_relaxed);
+    if (count < 2.0 || total <= 0.0)
+        return std::numeric_limits<double>::infinity();
+
+    double totalSquared = sumWW.load(std::memory_order_relaxed);
+    double worst = 0.0;
+    for (size_t group = 0; group < groups; ++group) {
+        double q = sumC[group].load(std::memory_order_relaxed) / total;
+        double spread = sumCC[group].load(std::memory_order_relaxed) -
+                        2.0 * q * sumCW[group].load(std::memory_order_relaxed) + q * q * totalSquared;
+        double error = std::sqrt(std::max(spread, 0.0) * count / (count - 1.0)) / (total * groupCells[group]);
+        worst = std::max(worst, error);
+    }
+    return worst;
+}
+
+}  // namespace solver
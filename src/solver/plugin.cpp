@@ -0,0 +1,186 @@
+#include "headers/solver/plugin.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "headers/solver/view.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace solver {
+
+static_assert(DANSWEEPER_TILE_1 == static_cast<int>(TILE_1) && DANSWEEPER_TILE_8 == static_cast<int>(TILE_8) &&
+                  DANSWEEPER_TILE_REVEALED == static_cast<int>(TILE_REVEALED) &&
+                  DANSWEEPER_TILE_BLANK == static_cast<int>(TILE_BLANK) && DANSWEEPER_TILE_FLAG == static_cast<int>(TILE_FLAG) &&
+                  DANSWEEPER_TILE_QUESTION == static_cast<int>(TILE_QUESTION),
+              "plugin tiles are the game's tiles");
+static_assert(static_cast<int>(CellLayout::ROW_MAJOR) == DANSWEEPER_LAYOUT_ROW_MAJOR &&
+                  static_cast<int>(CellLayout::MORTON) == DANSWEEPER_LAYOUT_MORTON,
+              "plugin layouts are the grid's layouts");
+static_assert(static_cast<int>(GameState::ONGOING) == 0 && static_cast<int>(GameState::WON) == 1 &&
+                  static_cast<int>(GameState::LOST) == 2,
+              "plugin game states are the grid's");
+
+#ifdef _WIN32
+
+SolverPlugin::SolverPlugin(const std::string& path) {
+    HMODULE module = LoadLibraryA(path.c_str());
+    if (!module)
+        throw std::runtime_error("Could not load solver plugin " + path);
+    auto entryPoint = reinterpret_cast<dansweeper_solver_plugin_entry_fn>(GetProcAddress(module, DANSWEEPER_PLUGIN_ENTRY));
+    if (!entryPoint) {
+        FreeLibrary(module);
+        throw std::runtime_error("Solver plugin has no " DANSWEEPER_PLUGIN_ENTRY ": " + path);
+    }
+    library = module;
+    entry = entryPoint();
+    if (!entry || entry->abi_version != DANSWEEPER_PLUGIN_ABI_VERSION) {
+        FreeLibrary(module);
+        throw std::runtime_error("Solver plugin was built for another abi version: " + path);
+    }
+}
+
+SolverPlugin::~SolverPlugin() {
+    FreeLibrary(static_cast<HMODULE>(library));
+}
+
+#else
+
+SolverPlugin::SolverPlugin(const std::string& path) {
+    // local so two builds of the same plugin keep their own symbols when loaded side by side
+    library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library)
+        throw std::runtime_error("Could not load solver plugin " + path + ": " + dlerror());
+    auto entryPoint = reinterpret_cast<dansweeper_solver_plugin_entry_fn>(dlsym(library, DANSWEEPER_PLUGIN_ENTRY));
+    if (!entryPoint) {
+        dlclose(library);
+        throw std::runtime_error("Solver plugin has no " DANSWEEPER_PLUGIN_ENTRY ": " + path);
+    }
+    entry = entryPoint();
+    if (!entry || entry->abi_version != DANSWEEPER_PLUGIN_ABI_VERSION) {
+        dlclose(library);
+        throw std::runtime_error("Solver plugin was built for another abi version: " + path);
+    }
+}
+
+SolverPlugin::~SolverPlugin() {
+    dlclose(library);
+}
+
+#endif
+
+std::string SolverPlugin::name() const {
+    return entry->name ? entry->name : "unnamed";
+}
+
+PluginSolver::PluginSolver(const SolverPlugin& plugin, Grid* grid, uint64_t seed)
+    : plugin(plugin), grid(grid), moves(MOVE_CAPACITY), planes(grid->chunks.chunkCount()),
+      planeTable(grid->chunks.chunkCount(), nullptr) {
+    view.width = grid->width;
+    view.height = grid->height;
+    view.mines = grid->numMine;
+    view.chunk_size = CHUNK_SIZE;
+    view.chunks_wide = grid->chunksWide;
+    view.chunks_high = grid->chunksHigh;
+    view.cell_layout = static_cast<int32_t>(grid->cellLayout);
+    view.cell_bytes = 1;
+    view.tile_offset = 0;
+    view.chunks = planeTable.data();
+    grid->addListener(this);
+    refreshView();
+
+    state = plugin.api().create(&view, seed);
+    if (!state) {
+        grid->removeListener(this);
+        throw std::runtime_error("Solver plugin " + plugin.name() + " could not create a solver");
+    }
+}
+
+PluginSolver::~PluginSolver() {
+    plugin.api().destroy(state);
+    grid->removeListener(this);
+}
+
+void PluginSolver::onCellChanged(int x, int y) {
+    size_t index = static_cast<size_t>(y / CHUNK_SIZE) * grid->chunksWide + x / CHUNK_SIZE;
+    // a chunk the game just touched is copied whole, every later change is one byte
+    if (!planes[index]) {
+        copyChunk(index);
+        return;
+    }
+    planes[index][chunkCellIndex(grid->cellLayout, x % CHUNK_SIZE, y % CHUNK_SIZE)] = grid->tileAt(x, y);
+}
+
+void PluginSolver::onBoardChanged() {
+    allDirty = true;
+}
+
+void PluginSolver::copyChunk(size_t index) {
+    const Chunk* chunk = grid->chunks.tableData()[index];
+    if (!chunk) {
+        planes[index].reset();
+        planeTable[index] = nullptr;
+        return;
+    }
+    if (!planes[index])
+        planes[index] = std::make_unique<uint8_t[]>(CHUNK_CELLS);
+    for (int cell = 0; cell < CHUNK_CELLS; ++cell)
+        planes[index][cell] = static_cast<uint8_t>(chunk->cells[cell].renderTile);
+    planeTable[index] = planes[index].get();
+}
+
+void PluginSolver::refreshView() {
+    // the board was regenerated or the game ended, tiles changed without a cell by cell notification
+    if (allDirty) {
+        for (size_t index = 0; index < planes.size(); ++index)
+            copyChunk(index);
+        allDirty = false;
+    }
+    view.game_state = static_cast<int32_t>(grid->gameState);
+    view.visible_hash = grid->visibleHash;
+}
+
+ProbabilityMap PluginSolver::solve(std::chrono::nanoseconds budget) {
+    refreshView();
+    uint64_t budgetNs = static_cast<uint64_t>(budget.count());
+
+    auto start = std::chrono::steady_clock::now();
+    int32_t count = plugin.api().next_moves(state, &view, budgetNs, moves.data(), MOVE_CAPACITY);
+    uint64_t elapsed = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+    stats.calls++;
+    stats.lastNanoseconds = elapsed;
+    stats.totalNanoseconds += elapsed;
+    stats.maxNanoseconds = std::max(stats.maxNanoseconds, elapsed);
+    if (elapsed > budgetNs)
+        stats.overBudget++;
+
+    // moves are checked here, a plugin can't make the caller touch cells off the board or play moves that change
+    // nothing, a caller that keeps asking after one of those would never finish
+    ProbabilityMap result;
+    SolverView board(*grid);
+    count = std::min(std::max(count, 0), MOVE_CAPACITY);
+    for (int32_t i = 0; i < count; ++i) {
+        const dansweeper_move& move = moves[i];
+        if (!board.inBounds(move.x, move.y) || !board.isOpen(move.x, move.y)) {
+            stats.droppedMoves++;
+            continue;
+        }
+        if (move.kind == DANSWEEPER_MOVE_SAFE)
+            result.certain.safe.push_back({move.x, move.y});
+        else if (move.kind == DANSWEEPER_MOVE_MINE)
+            result.certain.mines.push_back({move.x, move.y});
+        else if (move.kind == DANSWEEPER_MOVE_GUESS && result.bestGuess.x < 0)
+            result.bestGuess = {move.x, move.y};
+    }
+    return result;
+}
+
+}  // namespace solver
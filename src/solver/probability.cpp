@@ -0,0 +1,515 @@
+#include "headers/solver/probability.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <numeric>
+
+#include "headers/solver/montecarlo.h"
+#include "headers/solver/transposition.h"
+#include "headers/solver/view.h"
+#include "headers/utils/hashutils.h"
+
+namespace solver {
+
+namespace {
+
+int findRoot(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<double> result(a.size() + b.size() - 1, 0.0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0.0)
+            continue;
+        for (size_t j = 0; j < b.size(); ++j)
+            result[i + j] += a[i] * b[j];
+    }
+    return result;
+}
+
+// keeps convolutions of many components from overflowing, the scale cancels out in the end
+void normalize(std::vector<double>& values) {
+    double largest = *std::max_element(values.begin(), values.end());
+    if (largest > 0.0)
+        for (double& value : values)
+            value /= largest;
+}
+
+double logChoose(int64_t n, int64_t k) {
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+// product of the mine distributions of components [lo, hi), one tree node per range
+void buildProducts(const std::vector<std::vector<double>>& dist, size_t node, size_t lo, size_t hi,
+                   std::vector<std::vector<double>>& tree) {
+    if (hi - lo == 1) {
+        tree[node] = dist[lo];
+        return;
+    }
+
+    size_t mid = (lo + hi) / 2;
+    buildProducts(dist, node * 2, lo, mid, tree);
+    buildProducts(dist, node * 2 + 1, mid, hi, tree);
+    tree[node] = convolve(tree[node * 2], tree[node * 2 + 1]);
+    normalize(tree[node]);
+}
+
+// result[t] = sum over y of sibling[y] * outside[t + y]
+std::vector<double> correlate(const std::vector<double>& outside, const std::vector<double>& sibling, size_t size) {
+    std::vector<double> result(size, 0.0);
+    for (size_t t = 0; t < size; ++t)
+        for (size_t y = 0; y < sibling.size() && t + y < outside.size(); ++y)
+            result[t] += sibling[y] * outside[t + y];
+    normalize(result);
+    return result;
+}
+
+// outside[t], weight of the rest of the board when components [lo, hi) hold t mines over their minimum
+// pushing it down the product tree gives every component the weight of all the others at O(M^2) overall,
+// instead of one convolution of everything else per component
+void pushWeights(const std::vector<std::vector<double>>& tree, size_t node, size_t lo, size_t hi,
+                 const std::vector<double>& outside, std::vector<std::vector<double>>& weights) {
+    if (hi - lo == 1) {
+        weights[lo] = outside;
+        return;
+    }
+
+    size_t mid = (lo + hi) / 2;
+    const std::vector<double>& left = tree[node * 2];
+    const std::vector<double>& right = tree[node * 2 + 1];
+    pushWeights(tree, node * 2, lo, mid, correlate(outside, right, left.size()), weights);
+    pushWeights(tree, node * 2 + 1, mid, hi, correlate(outside, left, right.size()), weights);
+}
+
+}  // namespace
+
+uint64_t hashComponent(const Component& component) {
+    // cells are sorted and rule vars follow cell order, so equal components serialize equally
+    std::vector<int64_t> words(component.cells.begin(), component.cells.end());
+    std::vector<std::vector<int64_t>> rules;
+    for (const Component::Rule& rule : component.rules) {
+        std::vector<int64_t> entry(rule.vars.begin(), rule.vars.end());
+        std::sort(entry.begin(), entry.end());
+        entry.push_back(-1 - rule.mines);
+        rules.push_back(std::move(entry));
+    }
+    std::sort(rules.begin(), rules.end());
+    for (const std::vector<int64_t>& rule : rules)
+        words.insert(words.end(), rule.begin(), rule.end());
+
+    return hashutils::xxh64(words.data(), words.size() * sizeof(int64_t), component.cells.size());
+}
+
+ProbabilitySolver::ProbabilitySolver(Grid* grid) {
+    this->grid = grid;
+    grid->addListener(this);
+    rescan();
+}
+
+ProbabilitySolver::~ProbabilitySolver() {
+    grid->removeListener(this);
+}
+
+ProbabilityMap ProbabilitySolver::solve() {
+    return solveUntil(Deadline::max());
+}
+
+ProbabilityMap ProbabilitySolver::solveWithin(std::chrono::microseconds budget) {
+    return solveUntil(std::chrono::steady_clock::now() + budget);
+}
+
+ProbabilityMap ProbabilitySolver::solveUntil(Deadline deadline) {
+    ProbabilityMap result;
+    int width = grid->getGridWidth();
+    if (transpositions && transpositions->findBoard(grid->visibleHash, result))
+        return result;
+
+    bool bounded = deadline != Deadline::max();
+    auto start = std::chrono::steady_clock::now();
+    Deadline exactDeadline = bounded ? start + (deadline - start) / 2 : deadline;
+
+    std::vector<int64_t> frontierCells;
+    std::vector<Component> components = buildComponents(frontierCells);
+    size_t count = components.size();
+
+    // smallest first, under a deadline the cheap ones should not wait behind one huge component
+    std::vector<size_t> bySize(count);
+    std::iota(bySize.begin(), bySize.end(), 0);
+    std::stable_sort(bySize.begin(), bySize.end(), [&](size_t a, size_t b) {
+        return components[a].cells.size() < components[b].cells.size();
+    });
+
+    // reuse whatever did not change since the last call, enumerate the rest
+    std::vector<uint64_t> hashes(count);
+    std::vector<const ComponentSolution*> solutions(count, nullptr);
+    std::vector<ComponentSolution> fresh(count);
+    std::vector<std::future<ComponentSolution>> pending(count);
+    std::vector<uint8_t> shared(count, 0);
+    std::vector<uint8_t> solved(count, 0);
+    std::unordered_map<uint64_t, ComponentSolution> nextCache;
+
+    for (size_t i : bySize) {
+        hashes[i] = hashComponent(components[i]);
+        auto cached = cache.find(hashes[i]);
+        if (cached != cache.end()) {
+            cacheHits++;
+            nextCache.insert(cache.extract(cached));
+            solved[i] = 1;
+            continue;
+        }
+
+        cacheMisses++;
+        if (transpositions && transpositions->findComponent(hashes[i], fresh[i])) {
+            shared[i] = 1;
+            continue;
+        }
+
+        auto enumerate = [this, exactDeadline](const Component& component) {
+            return ConstraintEngine(component).enumerate(nodeBudget, exactDeadline);
+        };
+        if (components[i].cells.size() >= parallelThreshold)
+            pending[i] = std::async(std::launch::async, enumerate, std::cref(components[i]));
+        else
+            fresh[i] = enumerate(components[i]);
+    }
+
+    std::vector<size_t> rough;
+    for (size_t i : bySize) {
+        if (pending[i].valid())
+            fresh[i] = pending[i].get();
+        if (!solved[i] && !fresh[i].exact)
+            rough.push_back(i);
+    }
+
+    // out of nodes or time, estimate instead, splitting what is left of the budget evenly
+    for (size_t r = 0; r < rough.size(); ++r) {
+        size_t i = rough[r];
+        Deadline slice = deadline;
+        if (bounded) {
+            auto now = std::chrono::steady_clock::now();
+            slice = now + std::max(deadline - now, Deadline::duration::zero()) / (rough.size() - r);
+        }
+        uint64_t limit = bounded ? UINT64_MAX : fallbackSamples;
+        if (sampler) {
+            fresh[i] = sampler->estimate(components[i], limit, slice, sampleTarget);
+            sampledComponents++;
+            convergedComponents += sampler->stats.converged;
+            sampledDescents += sampler->stats.samples;
+            if (std::isfinite(sampler->stats.standardError)) {
+                measuredComponents++;
+                sampleErrorSum += sampler->stats.standardError;
+                worstSampleError = std::max(worstSampleError, sampler->stats.standardError);
+            }
+        } else
+            fresh[i] = ConstraintEngine(components[i]).sample(rng, limit, slice);
+        result.samples += fresh[i].samples;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (solved[i])
+            continue;
+        if (transpositions && !shared[i] && fresh[i].exact)
+            transpositions->storeComponent(hashes[i], fresh[i]);
+        if (fresh[i].exact)
+            nextCache.emplace(hashes[i], std::move(fresh[i]));
+    }
+    // only the current frontier is worth keeping
+    cache = std::move(nextCache);
+    for (size_t i = 0; i < count; ++i) {
+        auto cached = cache.find(hashes[i]);
+        solutions[i] = cached != cache.end() ? &cached->second : &fresh[i];
+        result.exact = result.exact && solutions[i]->exact;
+    }
+
+    int64_t openCells = static_cast<int64_t>(width) * grid->getGridHeight() - grid->revealedSafeCells -
+                        static_cast<int64_t>(flaggedCells.size());
+    int64_t minesLeft = grid->totalMines - static_cast<int64_t>(flaggedCells.size());
+    int64_t interior = openCells - static_cast<int64_t>(frontierCells.size());
+    result.interiorCells = interior;
+
+    // each component's distribution over minMines..maxMines
+    // a sample that never reached a leaf says nothing, it is left out and its cells get the interior estimate
+    std::vector<std::vector<double>> dist(count);
+    std::vector<int> low(count, 0);
+    std::vector<uint8_t> blind(count, 0);
+    int64_t lowTotal = 0;
+    size_t highTotal = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ComponentSolution& solution = *solutions[i];
+        if (solution.maxMines < solution.minMines) {
+            blind[i] = !solution.exact;
+            dist[i] = {solution.exact ? 0.0 : 1.0};
+        } else {
+            low[i] = solution.minMines;
+            dist[i].assign(solution.ways.begin() + solution.minMines, solution.ways.begin() + solution.maxMines + 1);
+            normalize(dist[i]);
+        }
+        lowTotal += low[i];
+        highTotal += dist[i].size() - 1;
+    }
+
+    // weight of leaving k mines to the interior, relative to the best k so it stays finite
+    std::vector<double> outside(highTotal + 1, 0.0);
+    double bestLog = -INFINITY;
+    std::vector<double> logs(outside.size(), -INFINITY);
+    for (size_t t = 0; t < logs.size(); ++t) {
+        int64_t k = minesLeft - lowTotal - static_cast<int64_t>(t);
+        if (k >= 0 && k <= interior) {
+            logs[t] = logChoose(interior, k);
+            bestLog = std::max(bestLog, logs[t]);
+        }
+    }
+    for (size_t t = 0; t < logs.size(); ++t)
+        if (logs[t] > -INFINITY)
+            outside[t] = std::exp(logs[t] - bestLog);
+
+    std::vector<std::vector<double>> weights(count);
+    std::vector<double> total = {1.0};
+    if (count > 0) {
+        std::vector<std::vector<double>> tree(count * 4);
+        buildProducts(dist, 1, 0, count, tree);
+        total = tree[1];
+        pushWeights(tree, 1, 0, count, outside, weights);
+    }
+
+    // interior probability, expected mines left to the interior over its size
+    double weightSum = 0.0;
+    double interiorMines = 0.0;
+    for (size_t t = 0; t < total.size(); ++t) {
+        double weight = total[t] * outside[t];
+        weightSum += weight;
+        interiorMines += weight * static_cast<double>(minesLeft - lowTotal - static_cast<int64_t>(t));
+    }
+    if (weightSum > 0.0 && interior > 0)
+        result.interiorProbability = interiorMines / weightSum / static_cast<double>(interior);
+
+    for (size_t i = 0; i < count; ++i) {
+        const ComponentSolution& solution = *solutions[i];
+        const Component& component = components[i];
+        size_t cells = component.cells.size();
+
+        // g[j], weight of every board where this component holds minMines + j mines
+        const std::vector<double>& g = weights[i];
+        double norm = 0.0;
+        for (size_t j = 0; j < dist[i].size() && !blind[i]; ++j)
+            norm += solution.ways[low[i] + j] * g[j];
+
+        for (size_t c = 0; c < cells; ++c) {
+            double mine = 0.0;
+            bool alwaysMine = norm > 0.0;
+            for (size_t j = 0; j < dist[i].size() && !blind[i]; ++j) {
+                if (solution.ways[low[i] + j] == 0.0 || g[j] == 0.0)
+                    continue;
+                mine += solution.cellWays[j * cells + c] * g[j];
+                alwaysMine = alwaysMine && !solution.clearSeen[j * cells + c];
+            }
+            double probability = blind[i] ? result.interiorProbability : norm > 0.0 ? mine / norm : 0.0;
+            result.frontier[component.cells[c]] = probability;
+
+            int x = static_cast<int>(component.cells[c] % width);
+            int y = static_cast<int>(component.cells[c] / width);
+            // norm is zero when wrong flags leave no consistent filling, nothing is certain then
+            if (solution.exact && norm > 0.0 && mine == 0.0)
+                result.certain.safe.push_back({x, y});
+            else if (solution.exact && alwaysMine)
+                result.certain.mines.push_back({x, y});
+
+            if (probability < result.bestGuessProbability) {
+                result.bestGuessProbability = probability;
+                result.bestGuess = {x, y};
+            }
+        }
+    }
+
+    if (interior > 0 && result.interiorProbability < result.bestGuessProbability) {
+        CellPos cell = findInteriorCell(frontierCells);
+        if (cell.x >= 0) {
+            result.bestGuess = cell;
+            result.bestGuessProbability = result.interiorProbability;
+        }
+    }
+
+    if (transpositions && result.exact)
+        transpositions->storeBoard(grid->visibleHash, result);
+    return result;
+}
+
+std::vector<Component> ProbabilitySolver::buildComponents(std::vector<int64_t>& frontierCells) {
+    SolverView view(*grid);
+    int width = view.width();
+    int height = view.height();
+
+    struct RawRule {
+        std::vector<int64_t> cells;
+        int mines;
+    };
+    std::vector<RawRule> rawRules;
+    rawRules.reserve(constraintCells.size());
+
+    for (int64_t key : constraintCells) {
+        int x = static_cast<int>(key % width);
+        int y = static_cast<int>(key / width);
+        RawRule rule{{}, view.number(x, y)};
+
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+                    continue;
+
+                // read the tile directly, a set lookup per neighbor dominated large boards
+                TileId neighbor = view.tile(nx, ny);
+                if (isMarkedTile(neighbor))
+                    rule.mines--;
+                else if (isOpenTile(neighbor))
+                    rule.cells.push_back(cellKey(nx, ny, width));
+            }
+        }
+
+        if (!rule.cells.empty()) {
+            frontierCells.insert(frontierCells.end(), rule.cells.begin(), rule.cells.end());
+            rawRules.push_back(std::move(rule));
+        }
+    }
+
+    // sorted and unique, so a cell's index is its position and the hash does not depend on set order
+    std::sort(frontierCells.begin(), frontierCells.end());
+    frontierCells.erase(std::unique(frontierCells.begin(), frontierCells.end()), frontierCells.end());
+    auto indexOf = [&](int64_t key) {
+        return static_cast<int>(std::lower_bound(frontierCells.begin(), frontierCells.end(), key) - frontierCells.begin());
+    };
+
+    std::vector<int> parent(frontierCells.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<std::vector<int>> ruleIndices(rawRules.size());
+    for (size_t r = 0; r < rawRules.size(); ++r) {
+        for (int64_t key : rawRules[r].cells)
+            ruleIndices[r].push_back(indexOf(key));
+        int first = findRoot(parent, ruleIndices[r].front());
+        for (int i : ruleIndices[r])
+            parent[findRoot(parent, i)] = first;
+    }
+
+    std::vector<int> componentOf(frontierCells.size(), -1);
+    std::vector<int> localIndex(frontierCells.size());
+    std::vector<Component> components;
+    for (size_t i = 0; i < frontierCells.size(); ++i) {
+        int root = findRoot(parent, static_cast<int>(i));
+        if (componentOf[root] < 0) {
+            componentOf[root] = static_cast<int>(components.size());
+            components.emplace_back();
+        }
+        Component& component = components[componentOf[root]];
+        localIndex[i] = static_cast<int>(component.cells.size());
+        component.cells.push_back(frontierCells[i]);
+    }
+
+    for (size_t r = 0; r < rawRules.size(); ++r) {
+        Component& component = components[componentOf[findRoot(parent, ruleIndices[r].front())]];
+        Component::Rule local{{}, rawRules[r].mines};
+        for (int i : ruleIndices[r])
+            local.vars.push_back(localIndex[i]);
+        component.rules.push_back(std::move(local));
+    }
+
+    return components;
+}
+
+CellPos ProbabilitySolver::findInteriorCell(const std::vector<int64_t>& frontierCells) {
+    SolverView view(*grid);
+    int width = view.width();
+    int height = view.height();
+    auto onFrontier = [&](int x, int y) {
+        return std::binary_search(frontierCells.begin(), frontierCells.end(), cellKey(x, y, width));
+    };
+
+    // corners first, they open up the most often
+    const CellPos corners[] = {{0, 0}, {width - 1, 0}, {0, height - 1}, {width - 1, height - 1}};
+    for (CellPos corner : corners)
+        if (view.isOpen(corner.x, corner.y) && !onFrontier(corner.x, corner.y))
+            return corner;
+
+    for (int y = 0; y < height; ++y) {
+        for (int chunkX = 0; chunkX < view.chunkColumns(); ++chunkX) {
+            TileSpan span = view.row(y, chunkX);
+            for (int i = 0; i < span.size; ++i)
+                if (isOpenTile(span[i]) && !onFrontier(span.firstX + i, y))
+                    return {span.firstX + i, y};
+        }
+    }
+
+    return {-1, -1};
+}
+
+void ProbabilitySolver::refreshConstraint(int x, int y) {
+    SolverView view(*grid);
+    int width = view.width();
+    int height = view.height();
+    int64_t key = cellKey(x, y, width);
+
+    TileId tile = view.tile(x, y);
+    if (isMarkedTile(tile))
+        flaggedCells.insert(key);
+    else
+        flaggedCells.erase(key);
+
+    bool constraint = false;
+    if (TILE_NUMBERS[tile] > 0) {
+        for (int dy = -1; dy <= 1 && !constraint; ++dy) {
+            for (int dx = -1; dx <= 1 && !constraint; ++dx) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+                    continue;
+                constraint = view.isOpen(nx, ny);
+            }
+        }
+    }
+
+    if (constraint)
+        constraintCells.insert(key);
+    else
+        constraintCells.erase(key);
+}
+
+void ProbabilitySolver::onCellChanged(int x, int y) {
+    int width = grid->getGridWidth();
+    int height = grid->getGridHeight();
+    for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx)
+            if (x + dx >= 0 && x + dx < width && y + dy >= 0 && y + dy < height)
+                refreshConstraint(x + dx, y + dy);
+}
+
+void ProbabilitySolver::onBoardChanged() {
+    rescan();
+}
+
+void ProbabilitySolver::rescan() {
+    constraintCells.clear();
+    flaggedCells.clear();
+    cache.clear();
+
+    SolverView view(*grid);
+    int width = view.width();
+    int height = view.height();
+    for (int chunkY = 0; chunkY < view.chunkRows(); ++chunkY) {
+        for (int chunkX = 0; chunkX < view.chunkColumns(); ++chunkX) {
+            if (!view.chunkTouched(chunkX, chunkY))
+                continue;
+
+            for (int y = chunkY * CHUNK_SIZE; y < std::min((chunkY + 1) * CHUNK_SIZE, height); ++y)
+                for (int x = chunkX * CHUNK_SIZE; x < std::min((chunkX + 1) * CHUNK_SIZE, width); ++x)
+                    refreshConstraint(x, y);
+        }
+    }
+}
+
+}  // namespace solver
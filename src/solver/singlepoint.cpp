@@ -0,0 +1,260 @@
+#include "headers/solver/singlepoint.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+#include "headers/solver/patterns.h"
+#include "headers/solver/view.h"
+
+namespace solver {
+
+namespace {
+
+// neighbours of a cell at (dx, dy) from the window center, for dx and dy in -2..2
+constexpr std::array<std::array<uint64_t, 5>, 5> makeRings() {
+    std::array<std::array<uint64_t, 5>, 5> rings{};
+    for (int oy = -2; oy <= 2; ++oy)
+        for (int ox = -2; ox <= 2; ++ox)
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    if (dx != 0 || dy != 0)
+                        rings[oy + 2][ox + 2] |= uint64_t(1) << SinglePointSolver::windowBit(ox + dx, oy + dy);
+    return rings;
+}
+
+constexpr auto RINGS = makeRings();
+
+}  // namespace
+
+SinglePointSolver::SinglePointSolver(Grid* grid) {
+    this->grid = grid;
+    grid->addListener(this);
+    rescan();
+}
+
+SinglePointSolver::~SinglePointSolver() {
+    grid->removeListener(this);
+}
+
+Deductions SinglePointSolver::solve() {
+    return solve(std::chrono::steady_clock::time_point::max());
+}
+
+Deductions SinglePointSolver::solve(std::chrono::steady_clock::time_point deadline) {
+    Deductions result;
+    int width = grid->getGridWidth();
+    bool bounded = deadline != std::chrono::steady_clock::time_point::max();
+    uint64_t visited = 0;
+
+    Window window;
+    while (!worklist.empty()) {
+        // a reveal that opens half a huge board leaves a worklist worth seconds
+        if (bounded && ++visited % 256 == 0 && std::chrono::steady_clock::now() >= deadline)
+            break;
+        int64_t key = worklist.front();
+        worklist.pop_front();
+        queued.erase(key);
+
+        int x = static_cast<int>(key % width);
+        int y = static_cast<int>(key / width);
+        readWindow(x, y, 1, window);
+        int number = window.numbers[windowBit(0, 0)];
+        uint64_t ring = RINGS[2][2];
+        uint64_t open = window.open & ring;
+        if (number <= 0 || !open)
+            continue;
+        int need = number - std::popcount(window.mines & ring);
+
+        // the number alone, then every number in the 5x5 that shares an open cell with it
+        // a deduction changes the window, the center goes back in the worklist and is read again later
+        if (applyPattern(x, y, lookupPattern(need, 0, std::popcount(open), 0, 0), open, 0, 0, result))
+            continue;
+        readWindow(x, y, WINDOW_REACH, window);
+
+        for (int dy = -2; dy <= 2; ++dy) {
+            bool changed = false;
+            for (int dx = -2; dx <= 2 && !changed; ++dx) {
+                int other = window.numbers[windowBit(dx, dy)];
+                uint64_t otherRing = RINGS[dy + 2][dx + 2];
+                uint64_t otherOpen = window.open & otherRing;
+                if ((dx == 0 && dy == 0) || other <= 0 || !(open & otherOpen))
+                    continue;
+
+                uint64_t shared = open & otherOpen;
+                uint64_t onlyCenter = open & ~shared;
+                uint64_t onlyOther = otherOpen & ~shared;
+                int otherNeed = other - std::popcount(window.mines & otherRing);
+                uint8_t forces = lookupPattern(need, otherNeed, std::popcount(onlyCenter), std::popcount(shared),
+                                               std::popcount(onlyOther));
+                changed = applyPattern(x, y, forces, onlyCenter, shared, onlyOther, result);
+            }
+            if (changed) {
+                if (queued.insert(key).second)
+                    worklist.push_back(key);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// flags and deductions not yet applied count as mines, deduced safe cells as closed
+// reach 1 reads the number and its neighbours, a wider read keeps what the smaller one found
+void SinglePointSolver::readWindow(int x, int y, int reach, Window& window) {
+    SolverView view(*grid);
+    int width = view.width();
+    int height = view.height();
+    if (reach == 1) {
+        window.open = 0;
+        window.mines = 0;
+        window.numbers.fill(-1);
+    }
+
+    for (int dy = -reach; dy <= reach; ++dy) {
+        for (int dx = -reach; dx <= reach; ++dx) {
+            int nx = x + dx;
+            int ny = y + dy;
+            if ((reach > 1 && std::abs(dx) <= 1 && std::abs(dy) <= 1) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+                continue;
+
+            int bit = windowBit(dx, dy);
+            TileId tile = view.tile(nx, ny);
+            int number = TILE_NUMBERS[tile];
+            if (number >= 0) {
+                // only the inner 5x5 is ever read as a number
+                if (std::abs(dx) < WINDOW_REACH && std::abs(dy) < WINDOW_REACH)
+                    window.numbers[bit] = static_cast<int8_t>(number);
+                continue;
+            }
+
+            int64_t key = cellKey(nx, ny, width);
+            if (isMarkedTile(tile) || (!deducedMines.empty() && deducedMines.count(key)))
+                window.mines |= uint64_t(1) << bit;
+            else if (deducedSafe.empty() || !deducedSafe.count(key))
+                window.open |= uint64_t(1) << bit;
+        }
+    }
+}
+
+bool SinglePointSolver::applyPattern(int x, int y, uint8_t forces, uint64_t onlyCenter, uint64_t shared,
+                                     uint64_t onlyOther, Deductions& result) {
+    if (forces == 0 || (forces & FORCE_CONTRADICTION))
+        return false;
+
+    size_t before = result.safe.size() + result.mines.size();
+    const std::pair<uint64_t, uint8_t> parts[] = {
+        {onlyCenter, forces & (FORCE_ONLY_A_SAFE | FORCE_ONLY_A_MINE)},
+        {shared, forces & (FORCE_SHARED_SAFE | FORCE_SHARED_MINE)},
+        {onlyOther, forces & (FORCE_ONLY_B_SAFE | FORCE_ONLY_B_MINE)},
+    };
+
+    int width = grid->getGridWidth();
+    for (auto [cells, force] : parts) {
+        if (!force)
+            continue;
+        bool safe = force & (FORCE_ONLY_A_SAFE | FORCE_SHARED_SAFE | FORCE_ONLY_B_SAFE);
+        for (; cells; cells &= cells - 1) {
+            int bit = std::countr_zero(cells);
+            int64_t key = cellKey(x + bit % WINDOW_SIZE - WINDOW_REACH, y + bit / WINDOW_SIZE - WINDOW_REACH, width);
+            if (safe)
+                markSafe(key, result);
+            else
+                markMine(key, result);
+        }
+    }
+
+    return result.safe.size() + result.mines.size() > before;
+}
+
+void SinglePointSolver::markSafe(int64_t key, Deductions& result) {
+    if (!deducedSafe.insert(key).second)
+        return;
+
+    int width = grid->getGridWidth();
+    int x = static_cast<int>(key % width);
+    int y = static_cast<int>(key / width);
+    result.safe.push_back({x, y});
+    enqueueAround(x, y);
+}
+
+void SinglePointSolver::markMine(int64_t key, Deductions& result) {
+    if (!deducedMines.insert(key).second)
+        return;
+
+    int width = grid->getGridWidth();
+    int x = static_cast<int>(key % width);
+    int y = static_cast<int>(key / width);
+    result.mines.push_back({x, y});
+    enqueueAround(x, y);
+}
+
+bool SinglePointSolver::isKnownMine(int x, int y) const {
+    return deducedMines.count(cellKey(x, y, grid->getGridWidth())) || SolverView(*grid).isMarked(x, y);
+}
+
+bool SinglePointSolver::isKnownSafe(int x, int y) const {
+    return deducedSafe.count(cellKey(x, y, grid->getGridWidth())) > 0;
+}
+
+void SinglePointSolver::enqueueAround(int x, int y) {
+    int width = grid->getGridWidth();
+    int height = grid->getGridHeight();
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            int nx = x + dx;
+            int ny = y + dy;
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+                continue;
+
+            int64_t key = cellKey(nx, ny, width);
+            if (queued.insert(key).second)
+                worklist.push_back(key);
+        }
+    }
+}
+
+void SinglePointSolver::onCellChanged(int x, int y) {
+    // once the grid shows a deduction it no longer needs remembering, a flag already counts as a mine
+    int64_t key = cellKey(x, y, grid->getGridWidth());
+    deducedSafe.erase(key);
+    if (SolverView(*grid).isFlagged(x, y))
+        deducedMines.erase(key);
+    enqueueAround(x, y);
+}
+
+void SinglePointSolver::onBoardChanged() {
+    rescan();
+}
+
+void SinglePointSolver::rescan() {
+    worklist.clear();
+    queued.clear();
+    deducedSafe.clear();
+    deducedMines.clear();
+
+    // revealed cells can only sit in chunks that exist, no need to look anywhere else
+    SolverView view(*grid);
+    int width = view.width();
+    int height = view.height();
+    for (int chunkY = 0; chunkY < view.chunkRows(); ++chunkY) {
+        for (int chunkX = 0; chunkX < view.chunkColumns(); ++chunkX) {
+            if (!view.chunkTouched(chunkX, chunkY))
+                continue;
+
+            for (int y = chunkY * CHUNK_SIZE; y < std::min((chunkY + 1) * CHUNK_SIZE, height); ++y) {
+                TileSpan span = view.row(y, chunkX);
+                span.forEach([&](int i, TileId tile) {
+                    if (TILE_NUMBERS[tile] > 0) {
+                        int64_t key = cellKey(span.firstX + i, y, width);
+                        if (queued.insert(key).second)
+                            worklist.push_back(key);
+                    }
+                });
+            }
+        }
+    }
+}
+
+}  // namespace solver
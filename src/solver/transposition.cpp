@@ -0,0 +1,63 @@
+#include "headers/solver/transposition.h"
+
+namespace solver {
+
+TranspositionCache::TranspositionCache(size_t capacity) {
+    this->capacity = capacity;
+}
+
+bool TranspositionCache::findBoard(uint64_t hash, ProbabilityMap& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = boards.entries.find(hash);
+    if (it == boards.entries.end()) {
+        boardMisses++;
+        return false;
+    }
+
+    boardHits++;
+    result = it->second;
+    return true;
+}
+
+void TranspositionCache::storeBoard(uint64_t hash, const ProbabilityMap& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    store(boards, hash, result);
+}
+
+bool TranspositionCache::findComponent(uint64_t hash, ComponentSolution& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = components.entries.find(hash);
+    if (it == components.entries.end()) {
+        componentMisses++;
+        return false;
+    }
+
+    componentHits++;
+    result = it->second;
+    return true;
+}
+
+void TranspositionCache::storeComponent(uint64_t hash, const ComponentSolution& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    store(components, hash, result);
+}
+
+void TranspositionCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    boards = {};
+    components = {};
+}
+
+template <typename Value>
+void TranspositionCache::store(Table<Value>& table, uint64_t hash, const Value& value) {
+    if (capacity == 0 || !table.entries.insert_or_assign(hash, value).second)
+        return;
+
+    table.age.push_back(hash);
+    if (table.age.size() > capacity) {
+        table.entries.erase(table.age.front());
+        table.age.pop_front();
+    }
+}
+
+}  // namespace solver
@@ -9,6 +9,9 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "headers/grid.h"
+#include "headers/utils/hashutils.h"
+
 namespace gridutils {
 
 // --- encoding ---
@@ -17,47 +20,48 @@ std::string createSeedFromManualInput(uint16_t width, uint16_t height, uint32_t
 }
 
 std::string createBase64Seed(uint16_t width, uint16_t height, uint32_t numMines, uint16_t safeX, uint16_t safeY, uint64_t prngSeed) {
-    std::vector<uint8_t> bytes;
+    std::array<uint8_t, 20> bytes;
 
     // Width (2 bytes)
-    bytes.push_back((width >> 8) & 0xFF);
-    bytes.push_back(width & 0xFF);
+    bytes[0] = (width >> 8) & 0xFF;
+    bytes[1] = width & 0xFF;
 
     // Height (2 bytes)
-    bytes.push_back((height >> 8) & 0xFF);
-    bytes.push_back(height & 0xFF);
+    bytes[2] = (height >> 8) & 0xFF;
+    bytes[3] = height & 0xFF;
 
     // Number of mines (4 bytes)
-    bytes.push_back((numMines >> 24) & 0xFF);
-    bytes.push_back((numMines >> 16) & 0xFF);
-    bytes.push_back((numMines >> 8) & 0xFF);
-    bytes.push_back(numMines & 0xFF);
+    bytes[4] = (numMines >> 24) & 0xFF;
+    bytes[5] = (numMines >> 16) & 0xFF;
+    bytes[6] = (numMines >> 8) & 0xFF;
+    bytes[7] = numMines & 0xFF;
 
     // PRNG seed (8 bytes)
-    for (int i = 7; i >= 0; --i)
-        bytes.push_back((prngSeed >> (i * 8)) & 0xFF);
+    for (int i = 0; i < 8; ++i)
+        bytes[8 + i] = (prngSeed >> ((7 - i) * 8)) & 0xFF;
 
     // Safe X (2 bytes)
-    bytes.push_back((safeX >> 8) & 0xFF);
-    bytes.push_back(safeX & 0xFF);
+    bytes[16] = (safeX >> 8) & 0xFF;
+    bytes[17] = safeX & 0xFF;
 
     // Safe Y (2 bytes)
-    bytes.push_back((safeY >> 8) & 0xFF);
-    bytes.push_back(safeY & 0xFF);
+    bytes[18] = (safeY >> 8) & 0xFF;
+    bytes[19] = safeY & 0xFF;
 
     // Encode to Base64 (should result in 28 Base64 characters with padding)
-    return encodeBase64(bytes);
+    return encodeBase64(bytes.data(), bytes.size());
 }
 
-std::string encodeBase64(const std::vector<uint8_t>& data) {
+std::string encodeBase64(const uint8_t* data, size_t length) {
     const char* b64_table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
     std::string result;
+    result.reserve((length + 2) / 3 * 4);
 
     int val = 0;
     int valb = -6;
 
-    for (uint8_t c : data) {
-        val = (val << 8) | c;
+    for (size_t i = 0; i < length; ++i) {
+        val = (val << 8) | data[i];
         valb += 8;
         while (valb >= 0) {
             result.push_back(b64_table[(val >> valb) & 0x3F]);
@@ -76,6 +80,39 @@ std::string encodeBase64(const std::vector<uint8_t>& data) {
     return result;
 };
 
+// splitmix64 finalizer
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t deriveFreshSeed(uint16_t width, uint16_t height, uint32_t numMines, uint16_t safeX, uint16_t safeY, uint64_t timeNs) {
+    // pack the board parameters into one word and fold in the timestamp
+    // pure integer math, nothing allocated on the first click
+    uint64_t board = (static_cast<uint64_t>(width) << 48) | (static_cast<uint64_t>(height) << 32) | numMines;
+    uint64_t safe = (static_cast<uint64_t>(safeX) << 16) | safeY;
+
+    uint64_t h = mix64(timeNs + 0x9E3779B97F4A7C15ULL);
+    h = mix64(h ^ board);
+    h = mix64(h ^ safe);
+    return h;
+}
+
+uint64_t zobristBase(int width, int height, int64_t numMines) {
+    uint64_t h = mix64(static_cast<uint64_t>(width) << 32 | static_cast<uint32_t>(height));
+    return mix64(h ^ static_cast<uint64_t>(numMines));
+}
+
+uint64_t zobristKey(int64_t cellIndex, TileId tile) {
+    if (tile == TILE_BLANK)
+        return 0;
+    return mix64(static_cast<uint64_t>(cellIndex) * 32 + tile + 0x9E3779B97F4A7C15ULL);
+}
+
 // --- decoding ---
 GridMetadata decodeSeed(const std::string& seed) {
     try {
@@ -100,19 +137,16 @@ GridMetadata decodeSeed(const std::string& seed) {
     }
 
     // fall back random text
-    std::hash<std::string> hasher;
-    uint64_t prngSeed = hasher(seed);
+    uint64_t prngSeed = hashutils::hashString(seed);
 
     std::mt19937_64 gen(prngSeed);
-    std::uniform_int_distribution<int> sizeDist(10, 250);
-    uint16_t width = sizeDist(gen) / 7;
-    uint16_t height = sizeDist(gen) / 7;
+    uint16_t width = uniformInt(gen, 10, 250) / 7;
+    uint16_t height = uniformInt(gen, 10, 250) / 7;
 
     int maxCells = width * height;
     int minMines = std::max(1, static_cast<int>(maxCells * 0.15));
     int maxMines = std::max(minMines + 1, static_cast<int>(maxCells * 0.25));
-    std::uniform_int_distribution<int> mineDist(minMines, maxMines);
-    uint32_t numMines = mineDist(gen);
+    uint32_t numMines = uniformInt(gen, minMines, maxMines);
 
     return GridMetadata{width, height, (int)numMines, (int)prngSeed, -1, -1};  // safeX/Y unset
 };
@@ -163,8 +197,9 @@ GridMetadata validateMetadata(uint16_t width, uint16_t height, uint32_t numMines
     uint32_t validNumMines;
 
     if (numMines > validWidth * validHeight - 1) {
-        std::uniform_int_distribution<int> mineDist(((validWidth * validHeight) - 1) * 0.01f, ((validWidth * validHeight) - 1) * 0.25f);
-        validNumMines = mineDist(gen);
+        int minMines = ((validWidth * validHeight) - 1) * 0.01f;
+        int maxMines = ((validWidth * validHeight) - 1) * 0.25f;
+        validNumMines = uniformInt(gen, minMines, maxMines);
     } else {
         validNumMines = numMines;
     }
@@ -175,4 +210,73 @@ GridMetadata validateMetadata(uint16_t width, uint16_t height, uint32_t numMines
     return GridMetadata{validWidth, validHeight, (int)validNumMines, (int)prngSeed, validSafeX, validSafeY};
 }
 
+// --- portable random ---
+uint64_t uniformInt(std::mt19937_64& gen, uint64_t min, uint64_t max) {
+    uint64_t range = max - min + 1;
+    if (range == 0) {
+        return gen();  // full 64 bit range
+    }
+
+    // reject the low values that would bias the modulo
+    uint64_t threshold = (0 - range) % range;
+    uint64_t r;
+    do {
+        r = gen();
+    } while (r < threshold);
+
+    return min + r % range;
+}
+
+// --- mine placement ---
+IndexPermutation makeIndexPermutation(uint64_t population, uint64_t seed) {
+    IndexPermutation permutation;
+    permutation.population = population;
+
+    // smallest even-width power of two domain that covers the population, so cycle walking
+    // needs under 4 rounds on average
+    int bits = 2;
+    while (bits < 64 && (1ULL << bits) < population)
+        bits += 2;
+    permutation.halfBits = bits / 2;
+    permutation.halfMask = (1ULL << permutation.halfBits) - 1;
+
+    std::mt19937_64 gen(seed);
+    for (uint64_t& key : permutation.roundKeys)
+        key = gen();
+
+    return permutation;
+}
+
+uint64_t permuteIndex(const IndexPermutation& permutation, uint64_t index) {
+    do {
+        uint64_t left = index >> permutation.halfBits;
+        uint64_t right = index & permutation.halfMask;
+        for (uint64_t key : permutation.roundKeys) {
+            uint64_t next = left ^ (mix64(right ^ key) & permutation.halfMask);
+            left = right;
+            right = next;
+        }
+        index = (left << permutation.halfBits) | right;
+    } while (index >= permutation.population);
+
+    return index;
+}
+
+// rounds undone in reverse, cycle walking backwards lands on the same index the forward walk started from
+uint64_t unpermuteIndex(const IndexPermutation& permutation, uint64_t value) {
+    uint64_t index = value;
+    do {
+        uint64_t left = index >> permutation.halfBits;
+        uint64_t right = index & permutation.halfMask;
+        for (auto key = permutation.roundKeys.rbegin(); key != permutation.roundKeys.rend(); ++key) {
+            uint64_t previous = right ^ (mix64(left ^ *key) & permutation.halfMask);
+            right = left;
+            left = previous;
+        }
+        index = (left << permutation.halfBits) | right;
+    } while (index >= permutation.population);
+
+    return index;
+}
+
 }  // namespace gridutils
\ No newline at end of file
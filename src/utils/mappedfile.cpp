@@ -0,0 +1,161 @@
+#include "headers/utils/mappedfile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+void MappedFile::open(const std::string& path, size_t size, bool create) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                              create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Could not open backing file " + path);
+
+    LARGE_INTEGER fileSize;
+    if (create) {
+        // sparse so untouched chunks take no disk space
+        DWORD returned = 0;
+        DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &returned, nullptr);
+
+        fileSize.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(file, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+            CloseHandle(file);
+            throw std::runtime_error("Could not size backing file " + path);
+        }
+    } else if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::runtime_error("Could not read backing file size " + path);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        throw std::runtime_error("Could not map backing file " + path);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Could not map backing file " + path);
+    }
+
+    this->fileHandle = file;
+    this->mappingHandle = mapping;
+    this->base = static_cast<uint8_t*>(view);
+    this->length = static_cast<size_t>(fileSize.QuadPart);
+}
+
+void MappedFile::close() {
+    if (base)
+        UnmapViewOfFile(base);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+
+    base = nullptr;
+    length = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+void MappedFile::flush() {
+    if (base) {
+        FlushViewOfFile(base, 0);
+        FlushFileBuffers(fileHandle);
+    }
+}
+
+size_t MappedFile::pageSize() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+#else
+
+void MappedFile::open(const std::string& path, size_t size, bool create) {
+    close();
+
+    int flags = create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR;
+    int file = ::open(path.c_str(), flags, 0644);
+    if (file < 0)
+        throw std::runtime_error("Could not open backing file " + path);
+
+    if (create) {
+        // ftruncate leaves a hole, pages only hit the disk once a chunk is written
+        if (ftruncate(file, static_cast<off_t>(size)) != 0) {
+            ::close(file);
+            throw std::runtime_error("Could not size backing file " + path);
+        }
+    } else {
+        struct stat info;
+        if (fstat(file, &info) != 0) {
+            ::close(file);
+            throw std::runtime_error("Could not read backing file size " + path);
+        }
+        size = static_cast<size_t>(info.st_size);
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED) {
+        ::close(file);
+        throw std::runtime_error("Could not map backing file " + path);
+    }
+
+    this->fd = file;
+    this->base = static_cast<uint8_t*>(view);
+    this->length = size;
+}
+
+void MappedFile::close() {
+    if (base)
+        munmap(base, length);
+    if (fd >= 0)
+        ::close(fd);
+
+    base = nullptr;
+    length = 0;
+    fd = -1;
+}
+
+void MappedFile::flush() {
+    if (base)
+        msync(base, length, MS_SYNC);
+}
+
+size_t MappedFile::pageSize() {
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+#endif
+
+uint8_t* MappedFile::data() const {
+    return base;
+}
+
+size_t MappedFile::size() const {
+    return length;
+}
+
+bool MappedFile::isOpen() const {
+    return base != nullptr;
+}
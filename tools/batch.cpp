@@ -0,0 +1,620 @@
+// tools/batch.cpp
+// headless batch runner, plays every seed of a range with one solver and reports how it did
+//   make batch
+//   ./batch WIDTH HEIGHT MINES FIRST_SEED LAST_SEED [--solver anytime|probability|rules|bitboard] [--threads N] [--budget-us N]
+//                                                   [--sampler-threads N] [--sample-error E]
+//   ./batch WIDTH HEIGHT MINES FIRST_SEED LAST_SEED --plugin ./libsolver.so [--threads N] [--budget-us N]
+// a game is the seeded board the game itself would build for that prng seed with the first click in the middle,
+// so any game can be replayed in the gui from its seed
+// seeds go up to 4294967295, the board's metadata keeps 32 bits of the seed so a larger one would replay a smaller one
+// bitboard is rules with the single number rules run over the whole board at once by BitboardSolver, pairs of numbers
+// only once those find nothing, both stop at the same cells before every guess so on the same seeds they have to win
+// exactly the same games
+// --sampler-threads gives every game thread a pool of N threads for the components the anytime or probability solver
+// has to sample, --sample-error stops each of those once its worst standard error is under E instead of at the budget
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/solver/anytime.h"
+#include "headers/solver/bitboard.h"
+#include "headers/solver/montecarlo.h"
+#include "headers/solver/plugin.h"
+#include "headers/solver/probability.h"
+#include "headers/solver/singlepoint.h"
+#include "headers/solver/view.h"
+#include "headers/utils/gridutils.h"
+
+namespace {
+
+enum class SolverKind {
+    ANYTIME,
+    PROBABILITY,
+    RULES,
+    BITBOARD,
+    PLUGIN,
+};
+
+struct Options {
+    int width = 0;
+    int height = 0;
+    int mines = 0;
+    uint64_t firstSeed = 0;
+    uint64_t lastSeed = 0;
+    SolverKind solver = SolverKind::ANYTIME;
+    unsigned threads = 0;  // 0 is one per core
+    std::chrono::microseconds budget{5000};
+    std::string pluginPath;
+    const solver::SolverPlugin* plugin = nullptr;  // loaded once in main, shared by every worker
+    unsigned samplerThreads = 0;  // 0 samples on the game's own thread
+    double sampleError = 0.0;
+};
+
+// move latencies, 32 buckets per doubling so percentiles are within about 3%
+// millions of games make hundreds of millions of moves, far too many to keep and sort
+class LatencyHistogram {
+   public:
+    void add(uint64_t nanoseconds) {
+        buckets[bucketOf(nanoseconds)]++;
+        count++;
+        max = std::max(max, nanoseconds);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < buckets.size(); ++i)
+            buckets[i] += other.buckets[i];
+        count += other.count;
+        max = std::max(max, other.max);
+    }
+
+    // upper edge of the bucket holding the given fraction of moves
+    uint64_t percentile(double fraction) const {
+        uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank && seen > 0)
+                return std::min(bucketTop(static_cast<int>(i)), max);
+        }
+        return max;
+    }
+
+    uint64_t count = 0;
+    uint64_t max = 0;
+
+   private:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+
+    // values under SUB_BUCKETS get a bucket each, above that the top SUB_BITS + 1 bits pick one
+    static int bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS)
+            return static_cast<int>(value);
+        int exponent = std::bit_width(value) - 1 - SUB_BITS;
+        return (exponent + 1) * SUB_BUCKETS + static_cast<int>((value >> exponent) - SUB_BUCKETS);
+    }
+    static uint64_t bucketTop(int index) {
+        if (index < SUB_BUCKETS)
+            return static_cast<uint64_t>(index);
+        int exponent = index / SUB_BUCKETS - 1;
+        uint64_t mantissa = static_cast<uint64_t>(index % SUB_BUCKETS + SUB_BUCKETS);
+        return ((mantissa + 1) << exponent) - 1;
+    }
+
+    std::array<uint64_t, 64 * SUB_BUCKETS> buckets{};
+};
+
+struct Totals {
+    uint64_t games = 0;
+    uint64_t wins = 0;
+    uint64_t noGuessWins = 0;
+    uint64_t guesses = 0;
+    uint64_t moves = 0;
+    uint64_t stuck = 0;       // solver had no move left, or only moves that changed nothing
+    uint64_t overBudget = 0;  // plugin calls the host timed over the budget
+    LatencyHistogram latency;
+
+    // components the sampler pool estimated, only with --sampler-threads
+    uint64_t sampledComponents = 0;
+    uint64_t convergedComponents = 0;
+    uint64_t measuredComponents = 0;
+    uint64_t sampledDescents = 0;
+    double sampleErrorSum = 0.0;
+    double worstSampleError = 0.0;
+
+    void merge(const Totals& other) {
+        games += other.games;
+        wins += other.wins;
+        noGuessWins += other.noGuessWins;
+        guesses += other.guesses;
+        moves += other.moves;
+        stuck += other.stuck;
+        overBudget += other.overBudget;
+        latency.merge(other.latency);
+        sampledComponents += other.sampledComponents;
+        convergedComponents += other.convergedComponents;
+        measuredComponents += other.measuredComponents;
+        sampledDescents += other.sampledDescents;
+        sampleErrorSum += other.sampleErrorSum;
+        worstSampleError = std::max(worstSampleError, other.worstSampleError);
+    }
+};
+
+// seeds split evenly between workers up front, a worker that runs dry takes half of whoever has the most left
+// games on a seed range vary a lot in length, so without stealing the last few threads finish alone
+class SeedQueue {
+   public:
+    SeedQueue(uint64_t first, uint64_t last, unsigned workers) : ranges(workers) {
+        // total * i / workers would overflow on huge ranges, the first total % workers ranges take one extra seed
+        uint64_t total = last - first + 1;
+        uint64_t share = total / workers;
+        uint64_t extra = total % workers;
+        for (unsigned i = 0; i < workers; ++i) {
+            ranges[i].next = first + share * i + std::min<uint64_t>(i, extra);
+            ranges[i].end = first + share * (i + 1) + std::min<uint64_t>(i + 1, extra);
+        }
+    }
+
+    bool take(unsigned worker, uint64_t& seed) {
+        Range& own = ranges[worker];
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.next < own.end) {
+                seed = own.next++;
+                return true;
+            }
+        }
+
+        while (true) {
+            // the sizes read here may be stale, the split below rechecks under the victim's lock
+            Range* victim = nullptr;
+            uint64_t most = 0;
+            for (Range& range : ranges) {
+                std::lock_guard<std::mutex> lock(range.mutex);
+                if (range.end - range.next > most) {
+                    most = range.end - range.next;
+                    victim = &range;
+                }
+            }
+            if (!victim)
+                return false;
+
+            uint64_t from, to;
+            {
+                std::lock_guard<std::mutex> lock(victim->mutex);
+                uint64_t remaining = victim->end - victim->next;
+                if (remaining == 0)
+                    continue;
+                // the thief takes the upper half, a single seed left goes whole
+                from = victim->end - (remaining + 1) / 2;
+                to = victim->end;
+                victim->end = from;
+            }
+
+            std::lock_guard<std::mutex> lock(own.mutex);
+            seed = from;
+            own.next = from + 1;
+            own.end = to;
+            return true;
+        }
+    }
+
+   private:
+    struct Range {
+        std::mutex mutex;
+        uint64_t next = 0;
+        uint64_t end = 0;
+    };
+    std::vector<Range> ranges;
+};
+
+// one solver per game, asked for a move until the game ends
+class Player {
+   public:
+    virtual ~Player() = default;
+    // certain cells if any, otherwise bestGuess
+    virtual solver::ProbabilityMap next() = 0;
+    virtual uint64_t overBudget() const { return 0; }
+    // the last move ran out of budget before it found anything, the next one picks up where it stopped
+    virtual bool pending() const { return false; }
+    // the probability solver behind the moves, for its sampler counts
+    virtual const solver::ProbabilitySolver* probabilities() const { return nullptr; }
+};
+
+class AnytimePlayer : public Player {
+   public:
+    AnytimePlayer(Grid* grid, std::chrono::microseconds budget, solver::MonteCarloEstimator* sampler, double sampleError)
+        : anytime(grid, sampler), budget(budget) {
+        // every core already has its own game
+        anytime.probabilities.parallelThreshold = std::numeric_limits<size_t>::max();
+        anytime.probabilities.sampleTarget = sampleError;
+    }
+    solver::ProbabilityMap next() override { return anytime.solve(budget); }
+    bool pending() const override { return anytime.pending(); }
+    const solver::ProbabilitySolver* probabilities() const override { return &anytime.probabilities; }
+
+   private:
+    solver::AnytimeSolver anytime;
+    std::chrono::microseconds budget;
+};
+
+class ProbabilityPlayer : public Player {
+   public:
+    ProbabilityPlayer(Grid* grid, solver::MonteCarloEstimator* sampler, double sampleError) : solver(grid) {
+        solver.parallelThreshold = std::numeric_limits<size_t>::max();
+        solver.sampler = sampler;
+        solver.sampleTarget = sampleError;
+    }
+    solver::ProbabilityMap next() override { return solver.solve(); }
+    const solver::ProbabilitySolver* probabilities() const override { return &solver; }
+
+   private:
+    solver::ProbabilitySolver solver;
+};
+
+class PluginPlayer : public Player {
+   public:
+    PluginPlayer(const solver::SolverPlugin& plugin, Grid* grid, uint64_t seed, std::chrono::microseconds budget)
+        : plugin(plugin, grid, seed), budget(budget) {}
+    solver::ProbabilityMap next() override { return plugin.solve(budget); }
+    uint64_t overBudget() const override { return plugin.stats.overBudget; }
+
+   private:
+    solver::PluginSolver plugin;
+    std::chrono::microseconds budget;
+};
+
+// single point rules only, guesses a uniformly random open cell when they run dry
+// wholeBoard runs the single number rules through BitboardSolver first, over every number at once
+class RulesPlayer : public Player {
+   public:
+    RulesPlayer(Grid* grid, uint64_t seed, bool wholeBoard) : grid(grid), rules(grid), gen(seed) {
+        if (wholeBoard)
+            bitboard = std::make_unique<solver::BitboardSolver>(grid);
+    }
+
+    solver::ProbabilityMap next() override {
+        solver::ProbabilityMap result;
+        if (bitboard)
+            result.certain = bitboard->solve();
+        if (result.certain.empty())
+            result.certain = rules.solve();
+        if (!result.certain.empty())
+            return result;
+
+        int width = grid->getGridWidth();
+        int height = grid->getGridHeight();
+        for (int attempt = 0; attempt < width * height; ++attempt) {
+            int x = static_cast<int>(gridutils::uniformInt(gen, 0, width - 1));
+            int y = static_cast<int>(gridutils::uniformInt(gen, 0, height - 1));
+            if (isGuessable(x, y)) {
+                result.bestGuess = {x, y};
+                return result;
+            }
+        }
+        // nearly done boards, rejection keeps missing
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                if (isGuessable(x, y)) {
+                    result.bestGuess = {x, y};
+                    return result;
+                }
+        return result;
+    }
+
+   private:
+    bool isGuessable(int x, int y) const {
+        return solver::SolverView(*grid).isOpen(x, y) && !rules.isKnownMine(x, y);
+    }
+
+    Grid* grid;
+    solver::SinglePointSolver rules;
+    std::unique_ptr<solver::BitboardSolver> bitboard;
+    std::mt19937_64 gen;
+};
+
+std::unique_ptr<Player> makePlayer(const Options& options, Grid* grid, uint64_t seed,
+                                   solver::MonteCarloEstimator* sampler) {
+    switch (options.solver) {
+        case SolverKind::PROBABILITY:
+            return std::make_unique<ProbabilityPlayer>(grid, sampler, options.sampleError);
+        case SolverKind::RULES:
+            return std::make_unique<RulesPlayer>(grid, seed, false);
+        case SolverKind::BITBOARD:
+            return std::make_unique<RulesPlayer>(grid, seed, true);
+        case SolverKind::PLUGIN:
+            return std::make_unique<PluginPlayer>(*options.plugin, grid, seed, options.budget);
+        default:
+            return std::make_unique<AnytimePlayer>(grid, options.budget, sampler, options.sampleError);
+    }
+}
+
+// sampler is the game thread's own pool, null without --sampler-threads
+void playGame(const Options& options, uint64_t seed, Totals& totals, solver::MonteCarloEstimator* sampler) {
+    GridMetadata metadata{};
+    std::string seed32 = gridutils::createSeedFromManualInput(options.width, options.height, options.mines,
+                                                              options.width / 2, options.height / 2, seed);
+    Grid grid(metadata, seed32, true);
+    std::unique_ptr<Player> player = makePlayer(options, &grid, seed, sampler);
+    grid.reveal(grid.safeX, grid.safeY);
+
+    uint64_t guesses = 0;
+    while (grid.gameState == GameState::ONGOING) {
+        auto start = std::chrono::steady_clock::now();
+        solver::ProbabilityMap move = player->next();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        totals.latency.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        totals.moves++;
+
+        uint64_t before = grid.visibleHash;
+        for (const solver::CellPos& mine : move.certain.mines) {
+            if (!grid.getCellProperties(mine.x, mine.y).flagged)
+                grid.flag(mine.x, mine.y);
+        }
+        for (const solver::CellPos& safe : move.certain.safe) {
+            if (grid.gameState != GameState::ONGOING)
+                break;
+            if (!grid.getCellProperties(safe.x, safe.y).revealed)
+                grid.reveal(safe.x, safe.y);
+        }
+        if (grid.visibleHash == before && move.bestGuess.x >= 0) {
+            guesses++;
+            grid.reveal(move.bestGuess.x, move.bestGuess.y);
+        }
+
+        // a move that changes nothing would be asked for again forever, plugins are not trusted to avoid that
+        if (grid.visibleHash == before && grid.gameState == GameState::ONGOING) {
+            if (player->pending())
+                continue;
+            totals.stuck++;
+            break;
+        }
+    }
+
+    totals.games++;
+    totals.guesses += guesses;
+    totals.overBudget += player->overBudget();
+    if (const solver::ProbabilitySolver* probabilities = player->probabilities()) {
+        totals.sampledComponents += probabilities->sampledComponents;
+        totals.convergedComponents += probabilities->convergedComponents;
+        totals.measuredComponents += probabilities->measuredComponents;
+        totals.sampledDescents += probabilities->sampledDescents;
+        totals.sampleErrorSum += probabilities->sampleErrorSum;
+        totals.worstSampleError = std::max(totals.worstSampleError, probabilities->worstSampleError);
+    }
+    if (grid.gameState == GameState::WON) {
+        totals.wins++;
+        if (guesses == 0)
+            totals.noGuessWins++;
+    }
+}
+
+uint64_t parseNumber(const char* text, const char* what) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (!*text || *end || text[0] == '-')
+        throw std::runtime_error(std::string("bad ") + what + ": " + text);
+    return value;
+}
+
+Options parseOptions(int argc, char** argv) {
+    if (argc < 6)
+        throw std::runtime_error(
+            "usage: batch WIDTH HEIGHT MINES FIRST_SEED LAST_SEED [--solver anytime|probability|rules|bitboard] "
+            "[--plugin PATH] [--threads N] [--budget-us N] [--sampler-threads N] [--sample-error E]\n"
+            "seeds are 0 to 4294967295");
+
+    Options options;
+    options.width = static_cast<int>(parseNumber(argv[1], "width"));
+    options.height = static_cast<int>(parseNumber(argv[2], "height"));
+    options.mines = static_cast<int>(parseNumber(argv[3], "mines"));
+    options.firstSeed = parseNumber(argv[4], "first seed");
+    options.lastSeed = parseNumber(argv[5], "last seed");
+
+    for (int i = 6; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc)
+            throw std::runtime_error("missing value for " + flag);
+        std::string value = argv[++i];
+        if (flag == "--solver") {
+            if (value == "anytime")
+                options.solver = SolverKind::ANYTIME;
+            else if (value == "probability")
+                options.solver = SolverKind::PROBABILITY;
+            else if (value == "rules")
+                options.solver = SolverKind::RULES;
+            else if (value == "bitboard")
+                options.solver = SolverKind::BITBOARD;
+            else
+                throw std::runtime_error("unknown solver: " + value);
+        } else if (flag == "--plugin") {
+            options.solver = SolverKind::PLUGIN;
+            options.pluginPath = value;
+        } else if (flag == "--threads") {
+            options.threads = static_cast<unsigned>(parseNumber(value.c_str(), "thread count"));
+        } else if (flag == "--budget-us") {
+            options.budget = std::chrono::microseconds(parseNumber(value.c_str(), "budget"));
+        } else if (flag == "--sampler-threads") {
+            options.samplerThreads = static_cast<unsigned>(parseNumber(value.c_str(), "sampler thread count"));
+        } else if (flag == "--sample-error") {
+            char* end = nullptr;
+            options.sampleError = std::strtod(value.c_str(), &end);
+            if (value.empty() || *end || !(options.sampleError >= 0.0))
+                throw std::runtime_error("bad sample error: " + value);
+        } else {
+            throw std::runtime_error("unknown option: " + flag);
+        }
+    }
+
+    // seeds store the size mod 250, see gridutils::validateMetadata
+    if (options.width < 5 || options.width > 249 || options.height < 5 || options.height > 249)
+        throw std::runtime_error("width and height must be 5 to 249");
+    if (options.mines < 1 || options.mines >= options.width * options.height)
+        throw std::runtime_error("mines must leave at least one safe cell");
+    if (options.lastSeed < options.firstSeed)
+        throw std::runtime_error("last seed is before the first");
+    // GridMetadata::prngSeed is an int, seeds past 32 bits would play the board of their low 32 bits again
+    if (options.lastSeed > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("last seed must be at most " + std::to_string(std::numeric_limits<uint32_t>::max()));
+    bool sampling = options.solver == SolverKind::ANYTIME || options.solver == SolverKind::PROBABILITY;
+    if ((options.samplerThreads > 0 || options.sampleError > 0.0) && !sampling)
+        throw std::runtime_error("sampler options need the anytime or probability solver");
+    if (options.sampleError > 0.0 && options.samplerThreads == 0)
+        throw std::runtime_error("--sample-error needs --sampler-threads");
+    if (options.threads == 0)
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return options;
+}
+
+const char* solverName(SolverKind kind) {
+    switch (kind) {
+        case SolverKind::PROBABILITY:
+            return "probability";
+        case SolverKind::RULES:
+            return "rules";
+        case SolverKind::BITBOARD:
+            return "bitboard";
+        case SolverKind::PLUGIN:
+            return "plugin";
+        default:
+            return "anytime";
+    }
+}
+
+double microseconds(uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::unique_ptr<solver::SolverPlugin> plugin;
+    try {
+        options = parseOptions(argc, argv);
+        if (options.solver == SolverKind::PLUGIN) {
+            plugin = std::make_unique<solver::SolverPlugin>(options.pluginPath);
+            options.plugin = plugin.get();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    uint64_t total = options.lastSeed - options.firstSeed + 1;
+    unsigned threads = static_cast<unsigned>(std::min<uint64_t>(options.threads, total));
+    SeedQueue queue(options.firstSeed, options.lastSeed, threads);
+    std::vector<Totals> perThread(threads);
+    std::atomic<uint64_t> finished{0};
+    std::atomic<bool> failed{false};
+    std::mutex mutex;
+    std::condition_variable idle;
+    unsigned running = threads;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i] {
+            uint64_t seed = 0;
+            try {
+                std::unique_ptr<solver::MonteCarloEstimator> sampler;
+                if (options.samplerThreads > 0)
+                    sampler = std::make_unique<solver::MonteCarloEstimator>(options.samplerThreads, 0x5eed + i);
+                while (!failed && queue.take(i, seed)) {
+                    playGame(options, seed, perThread[i], sampler.get());
+                    finished.fetch_add(1, std::memory_order_relaxed);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "\nseed " << seed << ": " << e.what() << '\n';
+                failed = true;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0)
+                idle.notify_all();
+        });
+    }
+
+    // progress on stderr so stdout stays just the report
+    double seconds = 0.0;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!idle.wait_for(lock, std::chrono::milliseconds(500), [&] { return running == 0; })) {
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            uint64_t done = finished.load(std::memory_order_relaxed);
+            std::fprintf(stderr, "\r%llu / %llu games, %.0f games/s", static_cast<unsigned long long>(done),
+                         static_cast<unsigned long long>(total), done / seconds);
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (std::thread& worker : workers)
+        worker.join();
+    std::fprintf(stderr, "\n");
+    if (failed)
+        return 1;
+
+    Totals totals;
+    for (const Totals& part : perThread)
+        totals.merge(part);
+
+    double games = static_cast<double>(totals.games);
+    double winRate = totals.wins / games;
+    double margin = 1.96 * std::sqrt(winRate * (1.0 - winRate) / games);  // normal approximation, 95%
+
+    std::printf("%dx%d, %d mines, seeds %llu..%llu, %s solver", options.width, options.height, options.mines,
+                static_cast<unsigned long long>(options.firstSeed), static_cast<unsigned long long>(options.lastSeed),
+                solverName(options.solver));
+    if (options.solver == SolverKind::PLUGIN)
+        std::printf(" %s from %s", options.plugin->name().c_str(), options.pluginPath.c_str());
+    if (options.solver == SolverKind::ANYTIME || options.solver == SolverKind::PLUGIN)
+        std::printf(" (%lld us budget)", static_cast<long long>(options.budget.count()));
+    std::printf(", %u threads", threads);
+    if (options.samplerThreads > 0)
+        std::printf(" with %u sampler threads each", options.samplerThreads);
+    std::printf("\n");
+    std::printf("games      %llu\n", static_cast<unsigned long long>(totals.games));
+    std::printf("won        %llu (%.2f%% +- %.2f%%)\n", static_cast<unsigned long long>(totals.wins), winRate * 100.0,
+                margin * 100.0);
+    std::printf("no guess   %llu won without guessing\n", static_cast<unsigned long long>(totals.noGuessWins));
+    std::printf("guesses    %.3f per game\n", totals.guesses / games);
+    if (totals.stuck > 0)
+        std::printf("stuck      %llu games with no move left that changed the board\n", static_cast<unsigned long long>(totals.stuck));
+    if (totals.overBudget > 0)
+        std::printf("budget     %llu calls over\n", static_cast<unsigned long long>(totals.overBudget));
+    if (options.samplerThreads > 0) {
+        // a component cut off before its second batch has no error to report
+        double sampled = static_cast<double>(std::max<uint64_t>(totals.sampledComponents, 1));
+        double measured = static_cast<double>(std::max<uint64_t>(totals.measuredComponents, 1));
+        std::printf("sampler    %llu components, %.0f descents each, %llu converged",
+                    static_cast<unsigned long long>(totals.sampledComponents), totals.sampledDescents / sampled,
+                    static_cast<unsigned long long>(totals.convergedComponents));
+        if (options.sampleError > 0.0)
+            std::printf(" under %g", options.sampleError);
+        std::printf(", standard error mean %.4f worst %.4f, %llu too short to tell\n", totals.sampleErrorSum / measured,
+                    totals.worstSampleError,
+                    static_cast<unsigned long long>(totals.sampledComponents - totals.measuredComponents));
+    }
+    std::printf("speed      %.0f games/s, %.2f s\n", games / seconds, seconds);
+    std::printf("moves      %llu, %.1f per game\n", static_cast<unsigned long long>(totals.moves), totals.moves / games);
+    std::printf("latency    p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+                microseconds(totals.latency.percentile(0.50)), microseconds(totals.latency.percentile(0.90)),
+                microseconds(totals.latency.percentile(0.99)), microseconds(totals.latency.percentile(0.999)),
+                microseconds(totals.latency.max));
+    return 0;
+}
@@ -0,0 +1,347 @@
+// tools/check.cpp
+// headless checks of everything that has to come out the same on every toolchain, exits non zero on a mismatch
+//   make check
+//   ./check --bench    times the hash instead
+// seeded boards are pinned by a hash of where their mines are, a change here means every shared seed changed board
+// BitboardSolver is checked against a plain cell by cell fixpoint of the same two rules on partly played boards, so
+// the simd and scalar builds are held to the same answer
+// the observation encoder is checked against Grid::tileAt, so what it writes is what the game draws
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "headers/grid.h"
+#include "headers/ml/encoder.h"
+#include "headers/solver/bitboard.h"
+#include "headers/solver/view.h"
+#include "headers/utils/gridutils.h"
+#include "headers/utils/hashutils.h"
+
+namespace {
+
+int failures = 0;
+
+void expect(bool ok, const std::string& what) {
+    if (!ok) {
+        failures++;
+        std::printf("FAIL  %s\n", what.c_str());
+    }
+}
+
+std::string hex(uint64_t value) {
+    char text[19];
+    std::snprintf(text, sizeof(text), "0x%016llx", static_cast<unsigned long long>(value));
+    return text;
+}
+
+// the buffer xxhash's own sanity check hashes
+std::vector<uint8_t> sanityBuffer() {
+    std::vector<uint8_t> buffer(101);
+    uint32_t generator = 2654435761u;
+    for (uint8_t& byte : buffer) {
+        byte = static_cast<uint8_t>(generator >> 24);
+        generator *= generator;
+    }
+    return buffer;
+}
+
+void checkXxh64() {
+    struct Vector {
+        size_t length;
+        uint64_t seed;
+        uint64_t expected;
+    };
+    // published xxh64 sanity vectors, seed 2654435761 is xxhash's PRIME32_1
+    const Vector vectors[] = {
+        {0, 0, 0xEF46DB3751D8E999ull},   {0, 2654435761u, 0xAC75FDA2929B17EFull},
+        {1, 0, 0x4FCE394CC88952D8ull},   {1, 2654435761u, 0x739840CB819FA723ull},
+        {14, 0, 0xCFFA8DB881BC3A3Dull},  {14, 2654435761u, 0x5B9611585EFCC9CBull},
+        {101, 0, 0x0EAB543384F878ADull}, {101, 2654435761u, 0xCAA65939306F1E21ull},
+    };
+    std::vector<uint8_t> buffer = sanityBuffer();
+    for (const Vector& vector : vectors) {
+        uint64_t got = hashutils::xxh64(buffer.data(), vector.length, vector.seed);
+        expect(got == vector.expected, "xxh64 of " + std::to_string(vector.length) + " bytes, seed " +
+                                           std::to_string(vector.seed) + ": " + hex(got) + ", expected " +
+                                           hex(vector.expected));
+    }
+    expect(hashutils::hashString("abc") == 0x44BC2CF5AD770999ull, "hashString(\"abc\")");
+}
+
+// one bit per cell row major, then hashed, so the whole layout is one number
+uint64_t mineLayoutHash(const Grid& grid) {
+    std::vector<uint8_t> bits((static_cast<size_t>(grid.width) * grid.height + 7) / 8, 0);
+    for (int y = 0; y < grid.height; ++y)
+        for (int x = 0; x < grid.width; ++x)
+            if (grid.isMine(x, y)) {
+                size_t cell = static_cast<size_t>(y) * grid.width + x;
+                bits[cell / 8] |= static_cast<uint8_t>(1u << (cell % 8));
+            }
+    return hashutils::xxh64(bits.data(), bits.size());
+}
+
+void checkSeededBoards() {
+    struct Golden {
+        std::string seed;
+        int width;
+        int height;
+        int mines;
+        uint64_t layout;
+    };
+    // free text seeds go through the hash and the portable draws, base64 ones straight to the permutation
+    const std::vector<Golden> goldens = {
+        {"dansweeper", 8, 24, 28, 0xaa683d3081e1e553ull},
+        {"hello world", 8, 28, 48, 0x59fd29db99d44b94ull},
+        {"minesweeper", 21, 2, 8, 0x61432acf4c1dcebfull},
+        {gridutils::createSeedFromManualInput(30, 16, 99, 15, 8, 12345), 30, 16, 99, 0x099aedb1848727cbull},
+        {gridutils::createSeedFromManualInput(249, 249, 12000, 0, 0, 987654321), 249, 249, 12000, 0x96f511c4a72df33full},
+    };
+    for (const Golden& golden : goldens) {
+        for (CellLayout layout : {CellLayout::ROW_MAJOR, CellLayout::MORTON}) {
+            GridMetadata metadata = {};
+            GridStorageOptions storage;
+            storage.layout = layout;
+            Grid grid(metadata, golden.seed, true, storage);
+
+            std::string name = "seed \"" + golden.seed + "\"" + (layout == CellLayout::MORTON ? " morton" : "");
+            expect(grid.width == golden.width && grid.height == golden.height && grid.numMine == golden.mines,
+                   name + ": " + std::to_string(grid.width) + "x" + std::to_string(grid.height) + " with " +
+                       std::to_string(grid.numMine) + " mines");
+            uint64_t layoutHash = mineLayoutHash(grid);
+            expect(layoutHash == golden.layout, name + ": mine layout " + hex(layoutHash) + ", expected " +
+                                                    hex(golden.layout));
+        }
+    }
+}
+
+// a number with as many flags or decided mines as it shows clears the rest, one with as many open cells as it
+// is missing mines fills them, repeated cell by cell until nothing changes
+void naiveFixpoint(const Grid& grid, std::vector<solver::CellPos>& safe, std::vector<solver::CellPos>& mines) {
+    enum State : uint8_t { OPEN, MINE, SHOWN, SAFE };
+    solver::SolverView view(grid);
+    int width = grid.width;
+    int height = grid.height;
+    std::vector<uint8_t> state(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            state[static_cast<size_t>(y) * width + x] =
+                view.isMarked(x, y) ? MINE : view.isOpen(x, y) ? OPEN : SHOWN;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int number = view.number(x, y);
+                if (state[static_cast<size_t>(y) * width + x] != SHOWN || number < 0)
+                    continue;
+                int found = 0, open = 0;
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        if (view.inBounds(x + dx, y + dy)) {
+                            uint8_t around = state[static_cast<size_t>(y + dy) * width + x + dx];
+                            found += around == MINE;
+                            open += around == OPEN;
+                        }
+                if (open == 0 || (number != found && number != found + open))
+                    continue;
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (!view.inBounds(x + dx, y + dy))
+                            continue;
+                        uint8_t& around = state[static_cast<size_t>(y + dy) * width + x + dx];
+                        if (around != OPEN)
+                            continue;
+                        around = number == found ? SAFE : MINE;
+                        (around == SAFE ? safe : mines).push_back({x + dx, y + dy});
+                        changed = true;
+                    }
+            }
+        }
+    }
+}
+
+void sortCells(std::vector<solver::CellPos>& cells) {
+    std::sort(cells.begin(), cells.end(), [](solver::CellPos a, solver::CellPos b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+}
+
+void checkBitboard() {
+    // 40 boards of assorted sizes and densities, a few random safe clicks and flags in after the first
+    std::mt19937_64 gen(40);
+    for (int board = 0; board < 40; ++board) {
+        int width = static_cast<int>(gridutils::uniformInt(gen, 5, 249));
+        int height = static_cast<int>(gridutils::uniformInt(gen, 5, 249));
+        int mines = static_cast<int>(static_cast<int64_t>(width) * height * gridutils::uniformInt(gen, 12, 22) / 100);
+        GridMetadata metadata = {};
+        GridStorageOptions storage;
+        storage.layout = board % 2 ? CellLayout::MORTON : CellLayout::ROW_MAJOR;
+        Grid grid(metadata, gridutils::createSeedFromManualInput(width, height, mines, width / 2, height / 2, board),
+                  true, storage);
+        grid.reveal(width / 2, height / 2);
+        for (int click = 0; click < 30 && grid.gameState == GameState::ONGOING; ++click) {
+            int x = static_cast<int>(gridutils::uniformInt(gen, 0, width - 1));
+            int y = static_cast<int>(gridutils::uniformInt(gen, 0, height - 1));
+            if (!grid.isMine(x, y))
+                grid.reveal(x, y);
+            else if (!grid.getCellProperties(x, y).flagged && gridutils::uniformInt(gen, 0, 1))
+                grid.flag(x, y);
+        }
+
+        std::vector<solver::CellPos> safe, mined;
+        naiveFixpoint(grid, safe, mined);
+        solver::BitboardSolver bitboard(&grid);
+        solver::Deductions found = bitboard.solve();
+        sortCells(safe);
+        sortCells(mined);
+        sortCells(found.safe);
+        sortCells(found.mines);
+
+        std::string name = "bitboard on " + std::to_string(width) + "x" + std::to_string(height) + " board " +
+                           std::to_string(board);
+        auto same = [](const std::vector<solver::CellPos>& a, const std::vector<solver::CellPos>& b) {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                              [](solver::CellPos p, solver::CellPos q) { return p.x == q.x && p.y == q.y; });
+        };
+        expect(same(found.safe, safe) && same(found.mines, mined),
+               name + ": " + std::to_string(found.safe.size()) + " safe and " + std::to_string(found.mines.size()) +
+                   " mines, the fixpoint has " + std::to_string(safe.size()) + " and " +
+                   std::to_string(mined.size()));
+        bool agrees = true;
+        for (solver::CellPos cell : found.safe)
+            agrees = agrees && !grid.isMine(cell.x, cell.y);
+        for (solver::CellPos cell : found.mines)
+            agrees = agrees && grid.isMine(cell.x, cell.y);
+        expect(agrees, name + ": a decided cell disagrees with the mines");
+    }
+}
+
+// channel the game's own tile for a cell belongs in, see ml::ObservationChannel
+int expectedChannel(TileId tile) {
+    int number = solver::TILE_NUMBERS[tile];
+    if (number >= 0)
+        return ml::CHANNEL_NUMBER_0 + number;
+    if (tile == TILE_FLAG || tile == TILE_MINE_WRONG || tile == TILE_MINE_REVEALED || tile == TILE_MINE_HIT)
+        return ml::CHANNEL_FLAG;
+    return ml::CHANNEL_UNKNOWN;
+}
+
+template <typename T>
+void checkEncoding(const Grid& grid, const std::string& name) {
+    std::vector<T> output(ml::observationSize(grid));
+    size_t plane = static_cast<size_t>(grid.width) * grid.height;
+    for (ml::TensorLayout layout : {ml::TensorLayout::NCHW, ml::TensorLayout::NHWC}) {
+        ml::encodeBoard(grid, layout, output.data());
+        size_t wrong = 0;
+        for (int y = 0; y < grid.height; ++y) {
+            for (int x = 0; x < grid.width; ++x) {
+                size_t cell = static_cast<size_t>(y) * grid.width + x;
+                int channel = expectedChannel(grid.tileAt(x, y));
+                for (int c = 0; c < ml::OBSERVATION_CHANNELS; ++c) {
+                    size_t at = layout == ml::TensorLayout::NCHW ? c * plane + cell : cell * ml::OBSERVATION_CHANNELS + c;
+                    wrong += output[at] != (c == channel ? T(1) : T(0));
+                }
+            }
+        }
+        expect(wrong == 0, name + (layout == ml::TensorLayout::NCHW ? " nchw " : " nhwc ") +
+                               (sizeof(T) == 1 ? "uint8" : "float") + ": " + std::to_string(wrong) + " values off");
+    }
+}
+
+void checkEncoder() {
+    // big enough that most chunks are never touched, then a loss in a corner, which shows every mine
+    for (CellLayout layout : {CellLayout::ROW_MAJOR, CellLayout::MORTON}) {
+        GridMetadata metadata = {};
+        GridStorageOptions storage;
+        storage.layout = layout;
+        Grid grid(metadata, gridutils::createSeedFromManualInput(249, 200, 8000, 124, 100, 7), true, storage);
+        grid.reveal(124, 100);
+        std::mt19937_64 gen(7);
+        for (int click = 0; click < 40; ++click) {
+            int x = static_cast<int>(gridutils::uniformInt(gen, 0, grid.width - 1));
+            int y = static_cast<int>(gridutils::uniformInt(gen, 0, grid.height - 1));
+            if (grid.isMine(x, y))
+                grid.flag(x, y);
+            else
+                grid.reveal(x, y);
+        }
+
+        std::string name = std::string("encoder") + (layout == CellLayout::MORTON ? " morton" : "");
+        checkEncoding<float>(grid, name);
+        checkEncoding<uint8_t>(grid, name);
+
+        // first unflagged mine in row order, near the top left corner far from the opening
+        for (int cell = 0; grid.gameState == GameState::ONGOING; ++cell) {
+            int x = cell % grid.width;
+            int y = cell / grid.width;
+            if (grid.isMine(x, y) && !grid.getCellProperties(x, y).flagged)
+                grid.reveal(x, y);
+        }
+        expect(grid.gameState == GameState::LOST, name + ": the loss did not happen");
+        checkEncoding<float>(grid, name + " lost");
+        checkEncoding<uint8_t>(grid, name + " lost");
+    }
+}
+
+template <typename Hash>
+void benchHash(const char* name, size_t length, Hash hash) {
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < length; ++i)
+        data[i] = static_cast<uint8_t>(i * 131 + 7);
+
+    // enough calls for about 256 MiB each run, best of five
+    size_t calls = std::max<size_t>(1, (size_t(256) << 20) / length);
+    double best = 1e30;
+    uint64_t sink = 0;
+    for (int run = 0; run < 5; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t call = 0; call < calls; ++call) {
+            data[0] = static_cast<uint8_t>(call);
+            sink += hash(data.data(), length);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    double nanoseconds = best * 1e9 / calls;
+    double gigabytes = static_cast<double>(length) * calls / best / 1e9;
+    std::printf("%-10s %9zu bytes  %10.1f ns  %6.2f GB/s  (%llx)\n", name, length, nanoseconds, gigabytes,
+                static_cast<unsigned long long>(sink & 0xF));
+}
+
+void bench() {
+    // std::hash alongside for scale, it is what seeds used before and is not the same across toolchains
+    for (size_t length : {size_t(8), size_t(32), size_t(256), size_t(4096), size_t(1) << 20}) {
+        benchHash("xxh64", length, [](const uint8_t* data, size_t size) { return hashutils::xxh64(data, size); });
+        benchHash("std::hash", length, [](const uint8_t* data, size_t size) {
+            return static_cast<uint64_t>(
+                std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(data), size)));
+        });
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        bench();
+        return 0;
+    }
+
+    checkXxh64();
+    checkSeededBoards();
+    checkBitboard();
+    checkEncoder();
+    if (failures > 0) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,103 @@
+// tools/exampleplugin.c
+// smallest useful solver plugin, plain c against headers/solver/pluginabi.h
+//   make exampleplugin
+//   ./batch 30 16 99 1 10000 --plugin ./libdansweeper_exampleplugin.so
+// single numbers only, a number with as many hidden neighbours as mines left flags them all,
+// one with every mine flagged opens the rest, otherwise a random hidden cell is guessed
+#include <stdlib.h>
+
+#include "headers/solver/pluginabi.h"
+
+typedef struct example_solver {
+    uint64_t rng;
+} example_solver;
+
+static uint64_t nextRandom(example_solver* solver) {
+    // xorshift64
+    solver->rng ^= solver->rng << 13;
+    solver->rng ^= solver->rng >> 7;
+    solver->rng ^= solver->rng << 17;
+    return solver->rng;
+}
+
+static int isHidden(uint8_t tile) {
+    return tile == DANSWEEPER_TILE_BLANK || tile == DANSWEEPER_TILE_QUESTION;
+}
+
+static void* exampleCreate(const dansweeper_board_view* board, uint64_t seed) {
+    (void)board;
+    example_solver* solver = (example_solver*)malloc(sizeof(example_solver));
+    if (solver)
+        solver->rng = seed * 0x9E3779B97F4A7C15ull | 1;
+    return solver;
+}
+
+static void exampleDestroy(void* solver) {
+    free(solver);
+}
+
+static int32_t exampleNextMoves(void* state, const dansweeper_board_view* board, uint64_t budget_ns,
+                                dansweeper_move* moves, int32_t capacity) {
+    (void)budget_ns;
+    example_solver* solver = (example_solver*)state;
+    int32_t count = 0;
+
+    for (int32_t y = 0; y < board->height && count < capacity; ++y) {
+        for (int32_t x = 0; x < board->width && count < capacity; ++x) {
+            uint8_t tile = dansweeper_board_tile(board, x, y);
+            if (tile > DANSWEEPER_TILE_8)
+                continue;
+            int32_t number = tile - DANSWEEPER_TILE_1 + 1;
+
+            int32_t hidden = 0, flagged = 0;
+            for (int32_t ny = y - 1; ny <= y + 1; ++ny)
+                for (int32_t nx = x - 1; nx <= x + 1; ++nx) {
+                    if (nx < 0 || ny < 0 || nx >= board->width || ny >= board->height)
+                        continue;
+                    uint8_t around = dansweeper_board_tile(board, nx, ny);
+                    hidden += isHidden(around);
+                    flagged += around == DANSWEEPER_TILE_FLAG;
+                }
+            if (hidden == 0 || (flagged != number && hidden + flagged != number))
+                continue;
+
+            // the host skips repeats, so overlapping numbers naming a cell twice is fine
+            int32_t kind = flagged == number ? DANSWEEPER_MOVE_SAFE : DANSWEEPER_MOVE_MINE;
+            for (int32_t ny = y - 1; ny <= y + 1; ++ny)
+                for (int32_t nx = x - 1; nx <= x + 1; ++nx) {
+                    if (nx < 0 || ny < 0 || nx >= board->width || ny >= board->height || count >= capacity)
+                        continue;
+                    if (isHidden(dansweeper_board_tile(board, nx, ny))) {
+                        moves[count].x = nx;
+                        moves[count].y = ny;
+                        moves[count].kind = kind;
+                        count++;
+                    }
+                }
+        }
+    }
+    if (count > 0)
+        return count;
+
+    int64_t cells = (int64_t)board->width * board->height;
+    for (int64_t attempt = 0; attempt < cells * 4; ++attempt) {
+        int64_t cell = (int64_t)(nextRandom(solver) % (uint64_t)cells);
+        int32_t x = (int32_t)(cell % board->width);
+        int32_t y = (int32_t)(cell / board->width);
+        if (dansweeper_board_tile(board, x, y) == DANSWEEPER_TILE_BLANK) {
+            moves[0].x = x;
+            moves[0].y = y;
+            moves[0].kind = DANSWEEPER_MOVE_GUESS;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static const dansweeper_solver_plugin EXAMPLE_PLUGIN = {
+    DANSWEEPER_PLUGIN_ABI_VERSION, "example single point", exampleCreate, exampleDestroy, exampleNextMoves,
+};
+
+DANSWEEPER_PLUGIN_EXPORT const dansweeper_solver_plugin* dansweeper_solver_plugin_entry(void) {
+    return &EXAMPLE_PLUGIN;
+}